@@ -0,0 +1,68 @@
+#pragma once
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+//Fixed capacity FIFO shared between two threads
+template <typename T>
+class BoundedQueue
+{
+public:
+	BoundedQueue( size_t capacity )
+	{
+		maxSize = capacity;
+		closed = false;
+	}
+
+	//Add an item, waiting while the queue is full. Returns false if the queue has been closed
+	bool push( T item )
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		notFull.wait( lock, [this] { return closed || items.size() < maxSize; } );
+		if ( closed )
+		{
+			return false;
+		}
+		items.push_back( std::move( item ) );
+		notEmpty.notify_one();
+		return true;
+	}
+
+	//Take the oldest item, waiting while the queue is empty. Returns false once closed and drained
+	bool pop( T& item )
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		notEmpty.wait( lock, [this] { return closed || !items.empty(); } );
+		if ( items.empty() )
+		{
+			return false;
+		}
+		item = std::move( items.front() );
+		items.pop_front();
+		notFull.notify_one();
+		return true;
+	}
+
+	//Stop accepting items and wake every waiting thread
+	void close()
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		closed = true;
+		notEmpty.notify_all();
+		notFull.notify_all();
+	}
+
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		return items.size();
+	}
+
+private:
+	std::deque<T> items;
+	size_t maxSize;
+	bool closed;
+	std::mutex mutex;
+	std::condition_variable notEmpty;
+	std::condition_variable notFull;
+};
@@ -0,0 +1,876 @@
+#include "Collision.h"
+#include "ConvexHull.h"
+#include "MelkmanHull.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <cmath>
+
+//Batches smaller than this aren't worth more threads
+static size_t const minParallel = 1 << 10;
+
+//Vector between points of the Minkowski difference a - b
+struct Vec
+{
+	long long x;
+	long long y;
+};
+
+static long long dot( Vec u, Vec v )
+{
+	return u.x * v.x + u.y * v.y;
+}
+
+static long long cross( Vec u, Vec v )
+{
+	return u.x * v.y - u.y * v.x;
+}
+
+static Vec difference( Point p, Point q )
+{
+	return Vec{ (long long) p.getX() - q.getX(), (long long) p.getY() - q.getY() };
+}
+
+//Index of the point of hull furthest in direction d. Walks round the hull from hint, as the
+//distance along d rises to its highest and falls again round a convex polygon
+static int support( PointView hull, Vec d, int hint )
+{
+	int const n = hull.size();
+	int best = hint;
+	long long bestDot = d.x * hull[best].getX() + d.y * hull[best].getY();
+
+	for ( int step = 1; step >= -1; step -= 2 )
+	{
+		while ( true )
+		{
+			int const next = ( best + step + n ) % n;
+			long long const nextDot = d.x * hull[next].getX() + d.y * hull[next].getY();
+			if ( nextDot <= bestDot )
+			{
+				break;
+			}
+			best = next;
+			bestDot = nextDot;
+		}
+	}
+	return best;
+}
+
+//Support point of a - b in direction d, keeping the indices as hints for the next call
+static Vec supportDifference( PointView a, PointView b, Vec d, int& hintA, int& hintB )
+{
+	hintA = support( a, d, hintA );
+	hintB = support( b, Vec{ -d.x, -d.y }, hintB );
+	return difference( a[hintA], b[hintB] );
+}
+
+//Index of the leftmost point (ties broken by y), where the edges of a hull start in angle order
+static int leftmostIndex( PointView hull )
+{
+	return std::min_element( hull.begin(), hull.end(), wayToSort ) - hull.begin();
+}
+
+//Whether edge direction u comes before v going round from the leftmost point. Edges leaving the
+//leftmost point never point straight down, so angles are measured from there
+static bool comesBefore( Vec u, Vec v )
+{
+	bool const uSecondHalf = u.x < 0 || ( u.x == 0 && u.y < 0 );
+	bool const vSecondHalf = v.x < 0 || ( v.x == 0 && v.y < 0 );
+	if ( uSecondHalf != vSecondHalf )
+	{
+		return vSecondHalf;
+	}
+	return cross( u, v ) > 0;
+}
+
+//Edges of a hull in angle order, leaving out zero length ones
+static std::vector<Vec> edgesInOrder( PointView hull )
+{
+	int const n = hull.size();
+	int const start = leftmostIndex( hull );
+	std::vector<Vec> edges;
+	edges.reserve( n );
+	for ( int k = 0; k < n; k++ )
+	{
+		Vec const edge = difference( hull[( start + k + 1 ) % n], hull[( start + k ) % n] );
+		if ( edge.x != 0 || edge.y != 0 )
+		{
+			edges.push_back( edge );
+		}
+	}
+	return edges;
+}
+
+Polygon minkowskiSum( const Polygon& a, const Polygon& b )
+{
+	PointView const aPoints = a.getView();
+	PointView const bPoints = b.getView();
+	if ( aPoints.empty() || bPoints.empty() )
+	{
+		return Polygon();
+	}
+
+	//The leftmost point of the sum is the sum of the leftmost points. From there, walk the edges of
+	//both in angle order, taking edges that point the same way together
+	std::vector<Vec> const aEdges = edgesInOrder( aPoints );
+	std::vector<Vec> const bEdges = edgesInOrder( bPoints );
+	Point const& aStart = aPoints[leftmostIndex( aPoints )];
+	Point const& bStart = bPoints[leftmostIndex( bPoints )];
+	long long x = (long long) aStart.getX() + bStart.getX();
+	long long y = (long long) aStart.getY() + bStart.getY();
+
+	std::vector<Point> sumPoints;
+	sumPoints.reserve( aEdges.size() + bEdges.size() );
+	size_t i = 0;
+	size_t j = 0;
+	while ( i < aEdges.size() || j < bEdges.size() )
+	{
+		sumPoints.push_back( Point( (int) x, (int) y ) );
+
+		bool const takeA = j == bEdges.size() || ( i < aEdges.size() && !comesBefore( bEdges.at( j ), aEdges.at( i ) ) );
+		bool const takeB = i == aEdges.size() || ( j < bEdges.size() && !comesBefore( aEdges.at( i ), bEdges.at( j ) ) );
+		if ( takeA )
+		{
+			x += aEdges.at( i ).x;
+			y += aEdges.at( i ).y;
+			i++;
+		}
+		if ( takeB )
+		{
+			x += bEdges.at( j ).x;
+			y += bEdges.at( j ).y;
+			j++;
+		}
+	}
+
+	if ( sumPoints.empty() )
+	{
+		sumPoints.push_back( Point( (int) x, (int) y ) );
+	}
+	return Polygon( std::move( sumPoints ) );
+}
+
+//Whether the origin is on the face of a - b furthest along d, when that face passes through the
+//origin. The face is where the faces of a along d and of b against d meet, so check how far each
+//reaches along the face
+static bool originOnFace( PointView a, PointView b, Vec d, int aIndex, int bIndex )
+{
+	Vec const along{ -d.y, d.x };
+	int const n = a.size();
+	int const m = b.size();
+
+	//Each face is a point or an edge, with its ends next to each other
+	long long aLo = along.x * a[aIndex].getX() + along.y * a[aIndex].getY();
+	long long aHi = aLo;
+	long long const aDot = d.x * a[aIndex].getX() + d.y * a[aIndex].getY();
+	int const aNeighbours[2] = { ( aIndex + 1 ) % n, ( aIndex + n - 1 ) % n };
+	for ( int k = 0; k < 2; k++ )
+	{
+		Point const& p = a[aNeighbours[k]];
+		if ( d.x * p.getX() + d.y * p.getY() == aDot )
+		{
+			long long const t = along.x * p.getX() + along.y * p.getY();
+			aLo = std::min( aLo, t );
+			aHi = std::max( aHi, t );
+		}
+	}
+
+	long long bLo = along.x * b[bIndex].getX() + along.y * b[bIndex].getY();
+	long long bHi = bLo;
+	long long const bDot = d.x * b[bIndex].getX() + d.y * b[bIndex].getY();
+	int const bNeighbours[2] = { ( bIndex + 1 ) % m, ( bIndex + m - 1 ) % m };
+	for ( int k = 0; k < 2; k++ )
+	{
+		Point const& p = b[bNeighbours[k]];
+		if ( d.x * p.getX() + d.y * p.getY() == bDot )
+		{
+			long long const t = along.x * p.getX() + along.y * p.getY();
+			bLo = std::min( bLo, t );
+			bHi = std::max( bHi, t );
+		}
+	}
+
+	//The face of a - b runs from aLo - bHi to aHi - bLo along it
+	return aLo - bHi <= 0 && aHi - bLo >= 0;
+}
+
+//a - b as a polygon in hull order
+static Polygon minkowskiDifference( const Polygon& a, const Polygon& b )
+{
+	std::vector<Point> negated;
+	negated.reserve( b.getSize() );
+	PointView const bPoints = b.getView();
+	for ( size_t i = 0; i < bPoints.size(); i++ )
+	{
+		negated.push_back( Point( -bPoints[i].getX(), -bPoints[i].getY() ) );
+	}
+	return minkowskiSum( a, Polygon( std::move( negated ) ) );
+}
+
+bool hullsIntersect( const Polygon& a, const Polygon& b )
+{
+	PointView const aPoints = a.getView();
+	PointView const bPoints = b.getView();
+	if ( aPoints.empty() || bPoints.empty() )
+	{
+		return false;
+	}
+
+	//GJK looks for a triangle of points of a - b around the origin. Every step adds the point of
+	//a - b furthest towards the origin from the simplex; if that doesn't get past the origin, the
+	//two are apart
+	int hintA = 0;
+	int hintB = 0;
+	Vec simplex[3];
+	int nSimplex = 0;
+	Vec d = difference( bPoints[0], aPoints[0] );
+
+	//Each step gets closer to the origin, so this only runs out on rounding-free ties
+	int const maxSteps = aPoints.size() + bPoints.size() + 8;
+	for ( int step = 0; step < maxSteps; step++ )
+	{
+		if ( d.x == 0 && d.y == 0 )
+		{
+			//The origin is on the simplex
+			return true;
+		}
+
+		Vec const p = supportDifference( aPoints, bPoints, d, hintA, hintB );
+		long long const reach = dot( p, d );
+		if ( reach < 0 )
+		{
+			return false;
+		}
+		if ( reach == 0 )
+		{
+			//a - b ends exactly at the origin's line across d
+			return originOnFace( aPoints, bPoints, d, hintA, hintB );
+		}
+
+		simplex[nSimplex++] = p;
+		Vec const& newest = simplex[nSimplex - 1];
+		Vec const toOrigin{ -newest.x, -newest.y };
+		if ( nSimplex == 1 )
+		{
+			d = toOrigin;
+		}
+		else if ( nSimplex == 2 )
+		{
+			Vec const edge{ simplex[0].x - newest.x, simplex[0].y - newest.y };
+			if ( dot( edge, toOrigin ) > 0 )
+			{
+				long long const side = cross( edge, toOrigin );
+				if ( side == 0 )
+				{
+					//On the line, and past the newest point, so between the two
+					return true;
+				}
+				d = side > 0 ? Vec{ -edge.y, edge.x } : Vec{ edge.y, -edge.x };
+			}
+			else
+			{
+				simplex[0] = newest;
+				nSimplex = 1;
+				d = toOrigin;
+			}
+		}
+		else
+		{
+			Vec const ab{ simplex[1].x - newest.x, simplex[1].y - newest.y };
+			Vec const ac{ simplex[0].x - newest.x, simplex[0].y - newest.y };
+			bool const cLeftOfAB = cross( ab, ac ) > 0;
+			//Normals of the two new edges, pointing out of the triangle
+			Vec const abOut = cLeftOfAB ? Vec{ ab.y, -ab.x } : Vec{ -ab.y, ab.x };
+			Vec const acOut = cLeftOfAB ? Vec{ -ac.y, ac.x } : Vec{ ac.y, -ac.x };
+
+			if ( dot( abOut, toOrigin ) > 0 )
+			{
+				//Outside across the newest edge to b: keep that edge
+				simplex[0] = simplex[1];
+				simplex[1] = newest;
+				nSimplex = 2;
+				d = abOut;
+			}
+			else if ( dot( acOut, toOrigin ) > 0 )
+			{
+				simplex[1] = newest;
+				nSimplex = 2;
+				d = acOut;
+			}
+			else
+			{
+				return true;
+			}
+		}
+	}
+
+	//Fall back on the sum, exactly
+	return insideHull( minkowskiDifference( a, b ).getView(), Point( 0, 0 ) );
+}
+
+//Point of the segment from p to q closest to the origin
+static void closestOnSegment( const double p[2], const double q[2], double closest[2] )
+{
+	double const ex = q[0] - p[0];
+	double const ey = q[1] - p[1];
+	double const length = ex * ex + ey * ey;
+	double t = length > 0 ? -( p[0] * ex + p[1] * ey ) / length : 0;
+	t = std::min( 1.0, std::max( 0.0, t ) );
+	closest[0] = p[0] + t * ex;
+	closest[1] = p[1] + t * ey;
+}
+
+double hullDistance( const Polygon& a, const Polygon& b )
+{
+	PointView const aPoints = a.getView();
+	PointView const bPoints = b.getView();
+	if ( aPoints.empty() || bPoints.empty() || hullsIntersect( a, b ) )
+	{
+		return 0;
+	}
+
+	//GJK for the point of a - b nearest the origin: head for the origin from the nearest point found
+	//so far, and keep the segment of the simplex nearest it
+	int hintA = 0;
+	int hintB = 0;
+	Vec const start = difference( aPoints[0], bPoints[0] );
+	double v[2] = { (double) start.x, (double) start.y };
+	double simplex[2][2] = { { v[0], v[1] } };
+	int nSimplex = 1;
+
+	int const maxSteps = aPoints.size() + bPoints.size() + 8;
+	for ( int step = 0; step < maxSteps; step++ )
+	{
+		if ( v[0] == 0 && v[1] == 0 )
+		{
+			break;
+		}
+		//Support towards the origin, scaled up to whole numbers so the support stays exact
+		double const scale = (double) ( 1 << 20 ) / std::max( std::abs( v[0] ), std::abs( v[1] ) );
+		Vec const towards{ (long long) std::llround( -v[0] * scale ), (long long) std::llround( -v[1] * scale ) };
+		Vec const w = supportDifference( aPoints, bPoints, towards, hintA, hintB );
+		double const gain = ( v[0] * v[0] + v[1] * v[1] ) - ( v[0] * w.x + v[1] * w.y );
+		if ( gain <= 1e-12 * ( v[0] * v[0] + v[1] * v[1] ) )
+		{
+			break;
+		}
+
+		double const newest[2] = { (double) w.x, (double) w.y };
+		if ( nSimplex == 1 )
+		{
+			closestOnSegment( simplex[0], newest, v );
+			simplex[1][0] = newest[0];
+			simplex[1][1] = newest[1];
+			nSimplex = 2;
+		}
+		else
+		{
+			//Keep whichever old point makes the nearer segment with the newest one
+			double first[2];
+			double second[2];
+			closestOnSegment( simplex[0], newest, first );
+			closestOnSegment( simplex[1], newest, second );
+			int const keep = first[0] * first[0] + first[1] * first[1] <= second[0] * second[0] + second[1] * second[1] ? 0 : 1;
+			v[0] = keep == 0 ? first[0] : second[0];
+			v[1] = keep == 0 ? first[1] : second[1];
+			simplex[0][0] = simplex[keep][0];
+			simplex[0][1] = simplex[keep][1];
+			simplex[1][0] = newest[0];
+			simplex[1][1] = newest[1];
+		}
+	}
+	return std::sqrt( v[0] * v[0] + v[1] * v[1] );
+}
+
+double penetrationDepth( const Polygon& a, const Polygon& b )
+{
+	if ( !hullsIntersect( a, b ) )
+	{
+		return 0;
+	}
+
+	//EPA grows a polygon inside a - b until its nearest edge to the origin is an edge of a - b. In
+	//2D the whole of a - b only takes O(n + m) to build, so look at its edges directly
+	Polygon const sum = minkowskiDifference( a, b );
+	PointView const points = sum.getView();
+	int const n = points.size();
+	if ( n < 3 )
+	{
+		return 0;
+	}
+
+	Point const origin( 0, 0 );
+	double depth = -1;
+	for ( int i = 0; i < n; i++ )
+	{
+		Point const& p = points[i];
+		Point const& q = points[( i + 1 ) % n];
+		double const length = std::hypot( (double) q.getX() - p.getX(), (double) q.getY() - p.getY() );
+		double const distance = turn( p, q, origin ) / length;
+		if ( depth < 0 || distance < depth )
+		{
+			depth = distance;
+		}
+	}
+	return depth;
+}
+
+//Run work( first, last ) over [0, count) split across all cores, or on this thread if count is small
+template <typename Work>
+static void forEachChunk( size_t count, Work work )
+{
+	size_t const nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	if ( count < minParallel || nThreads == 1 )
+	{
+		work( 0, count );
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	size_t const chunk = ( count + nThreads - 1 ) / nThreads;
+	for ( size_t first = 0; first < count; first += chunk )
+	{
+		threads.push_back( std::thread( work, first, std::min( count, first + chunk ) ) );
+	}
+	for ( size_t t = 0; t < threads.size(); t++ )
+	{
+		threads.at( t ).join();
+	}
+}
+
+std::vector<std::pair<int, int>> findCollisions( const std::vector<Polygon>& hulls )
+{
+	//Bounding box of each hull
+	int const n = hulls.size();
+	std::vector<int> minX( n ), maxX( n ), minY( n ), maxY( n );
+	std::vector<int> order;
+	for ( int i = 0; i < n; i++ )
+	{
+		PointView const points = hulls.at( i ).getView();
+		if ( points.empty() )
+		{
+			continue;
+		}
+		minX.at( i ) = maxX.at( i ) = points[0].getX();
+		minY.at( i ) = maxY.at( i ) = points[0].getY();
+		for ( size_t k = 1; k < points.size(); k++ )
+		{
+			minX.at( i ) = std::min( minX.at( i ), points[k].getX() );
+			maxX.at( i ) = std::max( maxX.at( i ), points[k].getX() );
+			minY.at( i ) = std::min( minY.at( i ), points[k].getY() );
+			maxY.at( i ) = std::max( maxY.at( i ), points[k].getY() );
+		}
+		order.push_back( i );
+	}
+
+	//Sweep across x, keeping the boxes the sweep line is inside
+	std::sort( order.begin(), order.end(), [&minX]( int p, int q ) { return minX.at( p ) < minX.at( q ); } );
+	std::vector<std::pair<int, int>> candidates;
+	std::vector<int> active;
+	for ( size_t k = 0; k < order.size(); k++ )
+	{
+		int const i = order.at( k );
+		size_t kept = 0;
+		for ( size_t t = 0; t < active.size(); t++ )
+		{
+			int const j = active.at( t );
+			if ( maxX.at( j ) < minX.at( i ) )
+			{
+				continue;
+			}
+			active.at( kept++ ) = j;
+			if ( minY.at( j ) <= maxY.at( i ) && minY.at( i ) <= maxY.at( j ) )
+			{
+				candidates.push_back( std::make_pair( std::min( i, j ), std::max( i, j ) ) );
+			}
+		}
+		active.resize( kept );
+		active.push_back( i );
+	}
+
+	//Boxes overlapping doesn't mean the hulls do
+	std::vector<char> hit( candidates.size(), 0 );
+	forEachChunk( candidates.size(), [&]( size_t first, size_t last )
+	{
+		for ( size_t c = first; c < last; c++ )
+		{
+			hit.at( c ) = hullsIntersect( hulls.at( candidates.at( c ).first ), hulls.at( candidates.at( c ).second ) );
+		}
+	} );
+
+	std::vector<std::pair<int, int>> collisions;
+	for ( size_t c = 0; c < candidates.size(); c++ )
+	{
+		if ( hit.at( c ) )
+		{
+			collisions.push_back( candidates.at( c ) );
+		}
+	}
+	std::sort( collisions.begin(), collisions.end() );
+	return collisions;
+}
+
+std::vector<double> hullDistances( const std::vector<Polygon>& hulls, const std::vector<std::pair<int, int>>& pairs )
+{
+	std::vector<double> distances( pairs.size(), 0 );
+	forEachChunk( pairs.size(), [&]( size_t first, size_t last )
+	{
+		for ( size_t c = first; c < last; c++ )
+		{
+			distances.at( c ) = hullDistance( hulls.at( pairs.at( c ).first ), hulls.at( pairs.at( c ).second ) );
+		}
+	} );
+	return distances;
+}
+
+static int sign( long long value )
+{
+	return ( value > 0 ) - ( value < 0 );
+}
+
+//Whether c is on the segment from a to b, given that the three are on a line
+static bool between( Point a, Point b, Point c )
+{
+	//Every point is on a line with a single point, so only c itself is on it
+	if ( a == b )
+	{
+		return c == a;
+	}
+	if ( a.getX() != b.getX() )
+	{
+		return ( a.getX() <= c.getX() && c.getX() <= b.getX() ) || ( a.getX() >= c.getX() && c.getX() >= b.getX() );
+	}
+	return ( a.getY() <= c.getY() && c.getY() <= b.getY() ) || ( a.getY() >= c.getY() && c.getY() >= b.getY() );
+}
+
+enum Crossing
+{
+	CROSS_NONE,
+	//The segments cross at one point inside both
+	CROSS_PROPER,
+	//The segments meet at an end of one of them
+	CROSS_VERTEX,
+	//The segments overlap along a line, from p to q
+	CROSS_OVERLAP
+};
+
+//How the segment from a to b meets the segment from c to d. The tests are exact; only the crossing
+//point p is rounded to whole numbers
+static Crossing segmentCrossing( Point a, Point b, Point c, Point d, Point& p, Point& q )
+{
+	long long const denominator = cross( difference( b, a ), difference( d, c ) );
+	if ( denominator == 0 )
+	{
+		if ( turn( a, b, c ) != 0 )
+		{
+			return CROSS_NONE;
+		}
+		//On one line: find the stretch both cover
+		if ( between( a, b, c ) && between( a, b, d ) ) { p = c; q = d; return CROSS_OVERLAP; }
+		if ( between( c, d, a ) && between( c, d, b ) ) { p = a; q = b; return CROSS_OVERLAP; }
+		if ( between( a, b, c ) && between( c, d, b ) ) { p = c; q = b; return CROSS_OVERLAP; }
+		if ( between( a, b, c ) && between( c, d, a ) ) { p = c; q = a; return CROSS_OVERLAP; }
+		if ( between( a, b, d ) && between( c, d, b ) ) { p = d; q = b; return CROSS_OVERLAP; }
+		if ( between( a, b, d ) && between( c, d, a ) ) { p = d; q = a; return CROSS_OVERLAP; }
+		return CROSS_NONE;
+	}
+
+	//The crossing is a + s ( b - a ) = c + t ( d - c ), with s = sNumerator / denominator and the same for t
+	long long sNumerator = cross( difference( c, a ), difference( d, c ) );
+	long long tNumerator = cross( difference( c, a ), difference( b, a ) );
+	long long den = denominator;
+	if ( den < 0 )
+	{
+		sNumerator = -sNumerator;
+		tNumerator = -tNumerator;
+		den = -den;
+	}
+	if ( sNumerator < 0 || sNumerator > den || tNumerator < 0 || tNumerator > den )
+	{
+		return CROSS_NONE;
+	}
+
+	double const s = (double) sNumerator / den;
+	p = Point( (int) std::lround( a.getX() + s * ( (double) b.getX() - a.getX() ) ), (int) std::lround( a.getY() + s * ( (double) b.getY() - a.getY() ) ) );
+	if ( sNumerator == 0 || sNumerator == den || tNumerator == 0 || tNumerator == den )
+	{
+		//Exactly on an end, so no rounding
+		p = sNumerator == 0 ? a : sNumerator == den ? b : tNumerator == 0 ? c : d;
+		return CROSS_VERTEX;
+	}
+	return CROSS_PROPER;
+}
+
+//The points found, tidied into a hull. Rounding can leave repeats and slight dents
+static Polygon tidyHull( std::vector<Point>& points )
+{
+	std::vector<Point> kept;
+	for ( size_t i = 0; i < points.size(); i++ )
+	{
+		if ( kept.empty() || !( kept.back() == points.at( i ) ) )
+		{
+			kept.push_back( points.at( i ) );
+		}
+	}
+	while ( kept.size() > 1 && kept.back() == kept.front() )
+	{
+		kept.pop_back();
+	}
+	return melkmanHull( PointView( kept.data(), kept.size() ) );
+}
+
+//Where a convex polygon overlaps a point or a segment
+static Polygon clipSmall( PointView small, PointView hull )
+{
+	if ( small.size() == 1 )
+	{
+		return insideHull( hull, small[0] ) ? Polygon( std::vector<Point>( 1, small[0] ) ) : Polygon();
+	}
+	if ( hull.size() == 1 )
+	{
+		return insideHull( small, hull[0] ) ? Polygon( std::vector<Point>( 1, hull[0] ) ) : Polygon();
+	}
+
+	//Cut the segment down by each edge in turn
+	Point const& p = small[0];
+	Point const& q = small[1];
+	double t0 = 0;
+	double t1 = 1;
+	int const n = hull.size();
+	for ( int i = 0; i < n && n > 2; i++ )
+	{
+		Point const& e0 = hull[i];
+		Point const& e1 = hull[( i + 1 ) % n];
+		double const atP = (double) turn( e0, e1, p );
+		double const atQ = (double) turn( e0, e1, q );
+		if ( atP < 0 && atQ < 0 )
+		{
+			return Polygon();
+		}
+		if ( atP < 0 )
+		{
+			t0 = std::max( t0, atP / ( atP - atQ ) );
+		}
+		else if ( atQ < 0 )
+		{
+			t1 = std::min( t1, atP / ( atP - atQ ) );
+		}
+	}
+	if ( n <= 2 )
+	{
+		//Two segments: where they overlap, if anywhere
+		Point from, to;
+		Crossing const crossing = segmentCrossing( p, q, hull[0], hull[n - 1], from, to );
+		std::vector<Point> overlap;
+		if ( crossing == CROSS_OVERLAP )
+		{
+			overlap.push_back( from );
+			overlap.push_back( to );
+		}
+		else if ( crossing != CROSS_NONE )
+		{
+			overlap.push_back( from );
+		}
+		return tidyHull( overlap );
+	}
+	if ( t0 > t1 )
+	{
+		return Polygon();
+	}
+
+	std::vector<Point> clipped;
+	clipped.push_back( Point( (int) std::lround( p.getX() + t0 * ( (double) q.getX() - p.getX() ) ), (int) std::lround( p.getY() + t0 * ( (double) q.getY() - p.getY() ) ) ) );
+	clipped.push_back( Point( (int) std::lround( p.getX() + t1 * ( (double) q.getX() - p.getX() ) ), (int) std::lround( p.getY() + t1 * ( (double) q.getY() - p.getY() ) ) ) );
+	return tidyHull( clipped );
+}
+
+Polygon hullIntersection( const Polygon& a, const Polygon& b )
+{
+	PointView const p = a.getView();
+	PointView const q = b.getView();
+	int const n = p.size();
+	int const m = q.size();
+	if ( n == 0 || m == 0 )
+	{
+		return Polygon();
+	}
+	if ( n < 3 )
+	{
+		return clipSmall( p, q );
+	}
+	if ( m < 3 )
+	{
+		return clipSmall( q, p );
+	}
+
+	//O'Rourke, Chien, Olson and Naddor: walk an edge of each polygon round together, always moving
+	//on the one that is aiming at the other's line, and output the crossings and whichever chain is
+	//inside between them. Each edge is passed at most twice
+	enum Inside { INSIDE_UNKNOWN, INSIDE_P, INSIDE_Q };
+	Inside inside = INSIDE_UNKNOWN;
+	std::vector<Point> found;
+	int i = 0;
+	int j = 0;
+	int iSteps = 0;
+	int jSteps = 0;
+	do
+	{
+		int const iPrev = ( i + n - 1 ) % n;
+		int const jPrev = ( j + m - 1 ) % m;
+		Vec const edgeP = difference( p[i], p[iPrev] );
+		Vec const edgeQ = difference( q[j], q[jPrev] );
+		int const crossPQ = sign( cross( edgeP, edgeQ ) );
+		//Which side of each edge's line the head of the other edge is on
+		int const pSideOfQ = sign( turn( q[jPrev], q[j], p[i] ) );
+		int const qSideOfP = sign( turn( p[iPrev], p[i], q[j] ) );
+
+		Point meet, meetEnd;
+		Crossing const crossing = segmentCrossing( p[iPrev], p[i], q[jPrev], q[j], meet, meetEnd );
+		if ( crossing == CROSS_PROPER || crossing == CROSS_VERTEX )
+		{
+			if ( inside == INSIDE_UNKNOWN && found.empty() )
+			{
+				//Count the steps again from the first crossing
+				iSteps = 0;
+				jSteps = 0;
+			}
+			found.push_back( meet );
+			if ( pSideOfQ > 0 )
+			{
+				inside = INSIDE_P;
+			}
+			else if ( qSideOfP > 0 )
+			{
+				inside = INSIDE_Q;
+			}
+		}
+
+		//Edges overlapping the opposite way: the polygons only share that stretch
+		if ( crossing == CROSS_OVERLAP && dot( edgeP, edgeQ ) < 0 )
+		{
+			std::vector<Point> shared;
+			shared.push_back( meet );
+			shared.push_back( meetEnd );
+			return tidyHull( shared );
+		}
+		//Parallel edges facing apart: nothing in common
+		if ( crossPQ == 0 && pSideOfQ < 0 && qSideOfP < 0 )
+		{
+			return Polygon();
+		}
+
+		bool advanceP;
+		if ( crossPQ == 0 && pSideOfQ == 0 && qSideOfP == 0 )
+		{
+			//Along the same line, move the one that isn't inside
+			advanceP = inside != INSIDE_P;
+		}
+		else if ( crossPQ >= 0 )
+		{
+			advanceP = qSideOfP > 0;
+		}
+		else
+		{
+			advanceP = pSideOfQ <= 0;
+		}
+
+		if ( advanceP )
+		{
+			if ( inside == INSIDE_P )
+			{
+				found.push_back( p[i] );
+			}
+			i = ( i + 1 ) % n;
+			iSteps++;
+		}
+		else
+		{
+			if ( inside == INSIDE_Q )
+			{
+				found.push_back( q[j] );
+			}
+			j = ( j + 1 ) % m;
+			jSteps++;
+		}
+	} while ( ( iSteps < n || jSteps < m ) && iSteps < 2 * n && jSteps < 2 * m );
+
+	if ( inside != INSIDE_UNKNOWN )
+	{
+		return tidyHull( found );
+	}
+
+	//The boundaries never cross: one is inside the other, or they are apart (or just touch)
+	if ( insideHull( q, p[0] ) && std::all_of( p.begin(), p.end(), [&q]( const Point& v ) { return insideHull( q, v ); } ) )
+	{
+		return a;
+	}
+	if ( insideHull( p, q[0] ) && std::all_of( q.begin(), q.end(), [&p]( const Point& v ) { return insideHull( p, v ); } ) )
+	{
+		return b;
+	}
+	return tidyHull( found );
+}
+
+std::vector<Polygon> hullIntersections( const std::vector<Polygon>& hulls, const std::vector<std::pair<int, int>>& pairs )
+{
+	std::vector<Polygon> overlaps( pairs.size() );
+	forEachChunk( pairs.size(), [&]( size_t first, size_t last )
+	{
+		for ( size_t c = first; c < last; c++ )
+		{
+			overlaps.at( c ) = hullIntersection( hulls.at( pairs.at( c ).first ), hulls.at( pairs.at( c ).second ) );
+		}
+	} );
+	return overlaps;
+}
+
+void checkHullIntersection()
+{
+	//Points, segments and a triangle that only just meet, or only just miss: a, b and what they share
+	struct Case
+	{
+		const char* name;
+		std::vector<Point> a;
+		std::vector<Point> b;
+		std::vector<Point> expected;
+	};
+	std::vector<Point> const segment = { Point( 0, 0 ), Point( 10, 0 ) };
+	std::vector<Point> const upright = { Point( 0, 0 ), Point( 0, 10 ) };
+	std::vector<Point> const triangle = { Point( 0, 0 ), Point( 0, 10 ), Point( 10, 0 ) };
+	std::vector<Case> const cases = {
+		{ "point in line with a segment, past its end", segment, { Point( 20, 0 ) }, {} },
+		{ "point in line with an upright segment, past its end", upright, { Point( 0, 20 ) }, {} },
+		{ "point on a segment", segment, { Point( 5, 0 ) }, { Point( 5, 0 ) } },
+		{ "point at the end of a segment", segment, { Point( 10, 0 ) }, { Point( 10, 0 ) } },
+		{ "point beside a segment", segment, { Point( 5, 1 ) }, {} },
+		{ "same point", { Point( 5, 1 ) }, { Point( 5, 1 ) }, { Point( 5, 1 ) } },
+		{ "point in line with an edge, past its end", triangle, { Point( 20, 0 ) }, {} },
+		{ "segments overlapping", segment, { Point( 5, 0 ), Point( 15, 0 ) }, { Point( 5, 0 ), Point( 10, 0 ) } },
+		{ "segments in line, apart", segment, { Point( 15, 0 ), Point( 25, 0 ) }, {} },
+		{ "segment meeting a point written twice", segment, { Point( 20, 0 ), Point( 20, 0 ) }, {} }
+	};
+
+	int failures = 0;
+	for ( size_t c = 0; c < cases.size(); c++ )
+	{
+		Case const& test = cases.at( c );
+		std::vector<Point> expected = test.expected;
+		std::sort( expected.begin(), expected.end(), wayToSort );
+
+		//Either way round should give the same overlap
+		for ( int swap = 0; swap < 2; swap++ )
+		{
+			Polygon const a( swap ? test.b : test.a );
+			Polygon const b( swap ? test.a : test.b );
+			std::vector<Point> found = hullIntersection( a, b ).getPoints();
+			std::sort( found.begin(), found.end(), wayToSort );
+			if ( found != expected )
+			{
+				std::cout << "checkHullIntersection: " << test.name << ( swap ? " (swapped)" : "" ) << ": " << found.size() << " points, expected " << expected.size() << std::endl;
+				failures++;
+			}
+		}
+	}
+	std::cout << "checkHullIntersection: " << cases.size() << " cases, " << failures << " failed" << std::endl;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+
+#include <vector>
+#include <utility>
+
+//===========================================//
+//=================COLLISION=================//
+//All of these take convex polygons in hull order (as dcHull and convexHull return them) and treat
+//them as solid, so hulls that only touch count as intersecting. Coordinates must stay within
+//+-2^29 so sums and products of differences fit
+
+//Minkowski sum of two convex polygons in O(n + m), by merging their edges in angle order
+Polygon minkowskiSum( const Polygon& a, const Polygon& b );
+
+//Whether two convex polygons overlap, by GJK on exact integer predicates
+bool hullsIntersect( const Polygon& a, const Polygon& b );
+//Clearance between two convex polygons by GJK (0 if they intersect)
+double hullDistance( const Polygon& a, const Polygon& b );
+//How far a has to move to stop overlapping b (0 if they don't intersect)
+double penetrationDepth( const Polygon& a, const Polygon& b );
+
+//Pairs of hulls that intersect, first < second. Sweep and prune on bounding boxes picks the pairs
+//worth testing, then GJK tests them across all cores
+std::vector<std::pair<int, int>> findCollisions( const std::vector<Polygon>& hulls );
+//hullDistance for each pair of hulls, across all cores
+std::vector<double> hullDistances( const std::vector<Polygon>& hulls, const std::vector<std::pair<int, int>>& pairs );
+
+//Overlap of two convex polygons in O(n + m), as a polygon in hull order (a point or a segment if they
+//only touch). Every test is exact; crossing points are rounded to the nearest whole numbers
+Polygon hullIntersection( const Polygon& a, const Polygon& b );
+//hullIntersection for each pair of hulls, across all cores
+std::vector<Polygon> hullIntersections( const std::vector<Polygon>& hulls, const std::vector<std::pair<int, int>>& pairs );
+//Run hullIntersection on points and segments that only just touch or miss, printing any wrong answer
+void checkHullIntersection();
+//=================COLLISION=================//
+//===========================================//
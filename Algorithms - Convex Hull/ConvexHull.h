@@ -0,0 +1,56 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+
+#include <vector>
+
+//===========================================//
+//================CONVEX HULL================//
+//sort by x coordinate then y coordinate
+bool wayToSort( const Point& a, const Point& b );
+
+//calculate the gradient of the line between 2 points
+double gradient( Point p1, Point p2 );
+//claculate y intercept of line equation
+double yIntercept( double m, Point p );
+//calculate intersection of a line at a given x
+double intersection( double x, Point p1, Point p2 );
+//Which way 3 points turn (> 0 right turn, 0 straight on, < 0 left turn). Exact while coordinates
+//are within +-2^30, so the products fit in 64 bits
+long long turn( Point p1, Point p2, Point p3 );
+//Check if 3 points make a right turn
+bool rightTurn( Point p1, Point p2, Point p3 );
+//Whether p is inside or on a convex polygon given in hull order (on it, for one or two points)
+bool insideHull( PointView hull, Point p );
+//Add a * b to the 128 bit two's complement number hi:lo, for exact sums of 64 bit products
+void addProduct( long long a, long long b, unsigned long long& hi, unsigned long long& lo );
+//Sign of the 128 bit two's complement number hi:lo
+int sign128( unsigned long long hi, unsigned long long lo );
+
+//Divide and conquer convex hull
+Polygon dcHull( std::vector<Point> sortedPoints );
+//Divide and conquer convex hull of sortedPoints[begin, end)
+Polygon dcHull( std::vector<Point>& sortedPoints, size_t begin, size_t end );
+//Merge two polygons to create convex hull
+Polygon merge( Polygon leftPolygon, Polygon rightPolygon );
+//Merge two hulls separated by a vertical line, finding the tangents by binary search
+Polygon bridgeMerge( const Polygon& leftHull, const Polygon& rightHull );
+//Append count points of a hull to out, starting at index first and wrapping round the end
+void appendPoints( std::vector<Point>& out, PointView points, int first, int count );
+
+//Convex hull of polygon
+Polygon convexHull( std::vector<Point> sortedPoints );
+//Upper hull of polygon
+std::vector<Point>upperHull( std::vector<Point> points );
+//Lower hull of polygon
+std::vector<Point>lowerHull( std::vector<Point> points );
+
+//Reduce points in the columns [minX, minX + width) to the highest and lowest point of each column, sorted by x.
+//Points outside those columns are skipped
+std::vector<Point> columnExtrema( PointView points, int minX, int width );
+std::vector<Point> columnExtrema( const std::vector<Point>& points, int minX, int width );
+//Convex hull of points on a bounded grid (no sort required)
+Polygon gridHull( PointView points, int minX, int width );
+Polygon gridHull( const std::vector<Point>& points, int minX, int width );
+//================CONVEX HULL================//
+//===========================================//
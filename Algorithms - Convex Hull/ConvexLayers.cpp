@@ -0,0 +1,131 @@
+#include "ConvexLayers.h"
+#include "ConvexHull.h"
+#include "HullTree.h"
+
+#include <algorithm>
+#include <thread>
+
+//Peel every layer off points. Fills in layerOf for each point and, if layers isn't null, each layer's hull
+static void peelLayers( const std::vector<Point>& points, std::vector<int>& layerOf, std::vector<Polygon>* layers )
+{
+	//Layers with fewer points than this aren't worth a second thread
+	size_t const minParallel = 1 << 10;
+
+	layerOf.assign( points.size(), -1 );
+
+	std::vector<int> order( points.size() );
+	for ( size_t i = 0; i < order.size(); i++ )
+	{
+		order.at( i ) = i;
+	}
+	std::sort( order.begin(), order.end(), [&points]( int a, int b ) { return wayToSort( points.at( a ), points.at( b ) ); } );
+
+	//Peel one copy of each point. Duplicates share the layer of the copy that was peeled
+	std::vector<int> sorted;
+	std::vector<int> firstCopy( points.size() );
+	for ( size_t k = 0; k < order.size(); k++ )
+	{
+		if ( sorted.empty() || !( points.at( order.at( k ) ) == points.at( sorted.back() ) ) )
+		{
+			sorted.push_back( order.at( k ) );
+		}
+		firstCopy.at( order.at( k ) ) = sorted.back();
+	}
+
+	//The lower hull is the upper hull of the points turned upside down, which also reverses their order
+	int const n = sorted.size();
+	std::vector<Point> upperPoints( n );
+	std::vector<Point> lowerPoints( n );
+	for ( int k = 0; k < n; k++ )
+	{
+		Point const& p = points.at( sorted.at( k ) );
+		upperPoints.at( k ) = p;
+		lowerPoints.at( n - 1 - k ) = Point( -p.getX(), -p.getY() );
+	}
+	HullTree upperTree( std::move( upperPoints ) );
+	HullTree lowerTree( std::move( lowerPoints ) );
+
+	std::vector<int> upper;
+	std::vector<int> lower;
+	std::vector<int> upperRemoved;
+	std::vector<int> lowerRemoved;
+	size_t lastLayerSize = n;
+	for ( int layer = 0; upperTree.getSize() > 0; layer++ )
+	{
+		//The trees never share data, so big layers work on both at once
+		bool const parallel = lastLayerSize >= minParallel;
+		if ( parallel )
+		{
+			std::thread lowerThread( [&lowerTree, &lower]() { lower = lowerTree.upperHull(); } );
+			upper = upperTree.upperHull();
+			lowerThread.join();
+		}
+		else
+		{
+			upper = upperTree.upperHull();
+			lower = lowerTree.upperHull();
+		}
+
+		//Right turns from the leftmost point along the bottom, then back along the top. The two
+		//sides share their end points
+		std::vector<Point> hullPoints;
+		upperRemoved.clear();
+		lowerRemoved.clear();
+		for ( size_t k = lower.size(); k-- > 0; )
+		{
+			int const position = n - 1 - lower.at( k );
+			hullPoints.push_back( points.at( sorted.at( position ) ) );
+			layerOf.at( sorted.at( position ) ) = layer;
+			upperRemoved.push_back( position );
+		}
+		for ( size_t k = upper.size() - 1; k-- > 1; )
+		{
+			int const position = upper.at( k );
+			hullPoints.push_back( points.at( sorted.at( position ) ) );
+			layerOf.at( sorted.at( position ) ) = layer;
+			upperRemoved.push_back( position );
+		}
+		if ( layers != nullptr )
+		{
+			layers->push_back( Polygon( std::move( hullPoints ) ) );
+		}
+
+		std::sort( upperRemoved.begin(), upperRemoved.end() );
+		for ( size_t k = upperRemoved.size(); k-- > 0; )
+		{
+			lowerRemoved.push_back( n - 1 - upperRemoved.at( k ) );
+		}
+		lastLayerSize = upperRemoved.size();
+		if ( parallel )
+		{
+			std::thread lowerThread( [&lowerTree, &lowerRemoved]() { lowerTree.remove( lowerRemoved ); } );
+			upperTree.remove( upperRemoved );
+			lowerThread.join();
+		}
+		else
+		{
+			upperTree.remove( upperRemoved );
+			lowerTree.remove( lowerRemoved );
+		}
+	}
+
+	for ( size_t i = 0; i < points.size(); i++ )
+	{
+		layerOf.at( i ) = layerOf.at( firstCopy.at( i ) );
+	}
+}
+
+std::vector<Polygon> convexLayers( const std::vector<Point>& points )
+{
+	std::vector<int> layerOf;
+	std::vector<Polygon> layers;
+	peelLayers( points, layerOf, &layers );
+	return layers;
+}
+
+std::vector<int> convexLayerIndex( const std::vector<Point>& points )
+{
+	std::vector<int> layerOf;
+	peelLayers( points, layerOf, nullptr );
+	return layerOf;
+}
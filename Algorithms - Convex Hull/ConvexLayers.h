@@ -0,0 +1,16 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+
+#include <vector>
+
+//===========================================//
+//===============CONVEX LAYERS===============//
+//Peel points into convex layers, outermost first. Each layer is the hull of the points left once
+//every layer outside it has been removed. Only hull vertices belong to a layer: a point lying on
+//one of its edges, between two vertices, is left for the next layer in
+std::vector<Polygon> convexLayers( const std::vector<Point>& points );
+//Layer of each point (0 for the outer hull), in the same order as points
+std::vector<int> convexLayerIndex( const std::vector<Point>& points );
+//===============CONVEX LAYERS===============//
+//===========================================//
@@ -0,0 +1,1159 @@
+#include "Hull3.h"
+#include "ConvexHull.h"
+
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+
+int HullMesh::getFaceCount() const
+{
+	return origins.size() / 3;
+}
+
+int HullMesh::getNext( int edge ) const
+{
+	return edge % 3 == 2 ? edge - 2 : edge + 1;
+}
+
+bool wayToSort3( const Point3& a, const Point3& b )
+{
+	if ( a.getX() != b.getX() )
+	{
+		return a.getX() < b.getX();
+	}
+	else if ( a.getY() != b.getY() )
+	{
+		return a.getY() < b.getY();
+	}
+	else
+	{
+		return a.getZ() < b.getZ();
+	}
+}
+
+int orientation( const Point3& a, const Point3& b, const Point3& c, const Point3& d )
+{
+	long long const abx = b.getX() - (long long) a.getX();
+	long long const aby = b.getY() - (long long) a.getY();
+	long long const abz = b.getZ() - (long long) a.getZ();
+	long long const acx = c.getX() - (long long) a.getX();
+	long long const acy = c.getY() - (long long) a.getY();
+	long long const acz = c.getZ() - (long long) a.getZ();
+	long long const adx = d.getX() - (long long) a.getX();
+	long long const ady = d.getY() - (long long) a.getY();
+	long long const adz = d.getZ() - (long long) a.getZ();
+
+	//The differences are exact in doubles, so only the products round. Trust the sign when it is well
+	//clear of how far that rounding could have moved it
+	double const yz = (double) aby * acz;
+	double const zy = (double) abz * acy;
+	double const zx = (double) abz * acx;
+	double const xz = (double) abx * acz;
+	double const xy = (double) abx * acy;
+	double const yx = (double) aby * acx;
+	double const determinant = ( yz - zy ) * adx + ( zx - xz ) * ady + ( xy - yx ) * adz;
+	double const permanent = ( std::fabs( yz ) + std::fabs( zy ) ) * std::fabs( (double) adx ) + ( std::fabs( zx ) + std::fabs( xz ) ) * std::fabs( (double) ady ) + ( std::fabs( xy ) + std::fabs( yx ) ) * std::fabs( (double) adz );
+	if ( std::fabs( determinant ) > 1e-14 * permanent )
+	{
+		return determinant > 0 ? 1 : -1;
+	}
+
+	//Too close to call: the normal fits in 64 bits and the sum in 128
+	unsigned long long hi = 0;
+	unsigned long long lo = 0;
+	addProduct( aby * acz - abz * acy, adx, hi, lo );
+	addProduct( abz * acx - abx * acz, ady, hi, lo );
+	addProduct( abx * acy - aby * acx, adz, hi, lo );
+	return sign128( hi, lo );
+}
+
+//Builds the hull of sorted points by adding them in order. Each point comes after every point before
+//it, so it is outside their hull, and it usually sees one of the faces round the point added just
+//before it; if not, every face is searched. Finding the edge round the faces it sees takes as long as
+//there are faces to remove, and one point can see O(n) of them, so the worst case is O(n^2): points
+//on the moment curve ( t, t^2, t^3 ) all stay on the hull and each sees about as many faces as came
+//before it
+class MeshBuilder
+{
+public:
+	MeshBuilder( const Point3* first, const Point3* last );
+	HullMesh build();
+
+private:
+	int orient( int face, int vertex );
+	int addFace( int a, int b, int c );
+	void flatHull( int count, int third );
+	void insert( int vertex, bool searchAll );
+	HullMesh compact();
+
+	//The points, without repeats
+	std::vector<Point3> points;
+	//Three per face, as in HullMesh
+	std::vector<int> origins;
+	std::vector<int> twins;
+	//Three per face: ( b - a ) x ( c - a ), exact in 64 bits
+	std::vector<long long> normals;
+	std::vector<bool> alive;
+	std::vector<int> freeFaces;
+	//Faces made by the last insert(), which are the ones round the point it added
+	std::vector<int> lastFaces;
+
+	//Scratch for insert(): step when a face was found visible, minus step when found hidden
+	std::vector<int> seen;
+	int step;
+	std::vector<int> stack;
+	std::vector<int> visible;
+	std::vector<int> horizon;
+	//Each horizon edge as start, end and the hidden half-edge beside it
+	std::vector<int> horizonEnds;
+	//New face whose horizon edge starts at each vertex
+	std::vector<int> startFace;
+};
+
+MeshBuilder::MeshBuilder( const Point3* first, const Point3* last )
+{
+	points.reserve( last - first );
+	for ( const Point3* p = first; p != last; p++ )
+	{
+		if ( points.empty() || !( points.back() == *p ) )
+		{
+			points.push_back( *p );
+		}
+	}
+	step = 0;
+}
+
+//orientation() of a point against a face, using the face's stored normal
+int MeshBuilder::orient( int face, int vertex )
+{
+	const Point3& a = points[origins[3 * face]];
+	long long const nx = normals[3 * face];
+	long long const ny = normals[3 * face + 1];
+	long long const nz = normals[3 * face + 2];
+	long long const dx = points[vertex].getX() - (long long) a.getX();
+	long long const dy = points[vertex].getY() - (long long) a.getY();
+	long long const dz = points[vertex].getZ() - (long long) a.getZ();
+
+	double const x = (double) nx * dx;
+	double const y = (double) ny * dy;
+	double const z = (double) nz * dz;
+	double const determinant = x + y + z;
+	if ( std::fabs( determinant ) > 1e-14 * ( std::fabs( x ) + std::fabs( y ) + std::fabs( z ) ) )
+	{
+		return determinant > 0 ? 1 : -1;
+	}
+
+	unsigned long long hi = 0;
+	unsigned long long lo = 0;
+	addProduct( nx, dx, hi, lo );
+	addProduct( ny, dy, hi, lo );
+	addProduct( nz, dz, hi, lo );
+	return sign128( hi, lo );
+}
+
+int MeshBuilder::addFace( int a, int b, int c )
+{
+	int face;
+	if ( !freeFaces.empty() )
+	{
+		face = freeFaces.back();
+		freeFaces.pop_back();
+	}
+	else
+	{
+		face = alive.size();
+		origins.resize( origins.size() + 3 );
+		twins.resize( twins.size() + 3 );
+		normals.resize( normals.size() + 3 );
+		alive.push_back( false );
+		seen.push_back( 0 );
+	}
+	origins[3 * face] = a;
+	origins[3 * face + 1] = b;
+	origins[3 * face + 2] = c;
+	alive[face] = true;
+
+	long long const abx = points[b].getX() - (long long) points[a].getX();
+	long long const aby = points[b].getY() - (long long) points[a].getY();
+	long long const abz = points[b].getZ() - (long long) points[a].getZ();
+	long long const acx = points[c].getX() - (long long) points[a].getX();
+	long long const acy = points[c].getY() - (long long) points[a].getY();
+	long long const acz = points[c].getZ() - (long long) points[a].getZ();
+	normals[3 * face] = aby * acz - abz * acy;
+	normals[3 * face + 1] = abz * acx - abx * acz;
+	normals[3 * face + 2] = abx * acy - aby * acx;
+	return face;
+}
+
+HullMesh MeshBuilder::build()
+{
+	int const n = points.size();
+	if ( n < 3 )
+	{
+		HullMesh mesh;
+		mesh.vertices = points;
+		return mesh;
+	}
+
+	//The first point off the line through the first two
+	auto collinear = [this]( int c )
+	{
+		long long const abx = points[1].getX() - (long long) points[0].getX();
+		long long const aby = points[1].getY() - (long long) points[0].getY();
+		long long const abz = points[1].getZ() - (long long) points[0].getZ();
+		long long const acx = points[c].getX() - (long long) points[0].getX();
+		long long const acy = points[c].getY() - (long long) points[0].getY();
+		long long const acz = points[c].getZ() - (long long) points[0].getZ();
+		return aby * acz == abz * acy && abz * acx == abx * acz && abx * acy == aby * acx;
+	};
+	int third = 2;
+	while ( third < n && collinear( third ) )
+	{
+		third++;
+	}
+	if ( third == n )
+	{
+		//All on a line: sorted, so the ends are first and last
+		HullMesh mesh;
+		mesh.vertices.push_back( points.front() );
+		mesh.vertices.push_back( points.back() );
+		return mesh;
+	}
+
+	//The first point off that plane. Everything before it is flat, so starts as a polygon
+	int fourth = third + 1;
+	while ( fourth < n && orientation( points[0], points[1], points[third], points[fourth] ) == 0 )
+	{
+		fourth++;
+	}
+	startFace.assign( n, -1 );
+	flatHull( fourth, third );
+	if ( fourth == n )
+	{
+		return compact();
+	}
+
+	insert( fourth, true );
+	for ( int v = fourth + 1; v < n; v++ )
+	{
+		insert( v, false );
+	}
+	return compact();
+}
+
+//Both sides of the polygon round the first count points, which are on the plane through points 0, 1
+//and third. The top side faces the way ( 1 - 0 ) x ( third - 0 ) points
+void MeshBuilder::flatHull( int count, int third )
+{
+	long long const abx = points[1].getX() - (long long) points[0].getX();
+	long long const aby = points[1].getY() - (long long) points[0].getY();
+	long long const abz = points[1].getZ() - (long long) points[0].getZ();
+	long long const acx = points[third].getX() - (long long) points[0].getX();
+	long long const acy = points[third].getY() - (long long) points[0].getY();
+	long long const acz = points[third].getZ() - (long long) points[0].getZ();
+	long long const normal[3] = { aby * acz - abz * acy, abz * acx - abx * acz, abx * acy - aby * acx };
+
+	//Drop the coordinate the normal is longest in. Taking the other two in turn after it keeps the 2D
+	//turn equal to that part of the 3D normal
+	int axis = 0;
+	for ( int k = 1; k < 3; k++ )
+	{
+		if ( std::llabs( normal[k] ) > std::llabs( normal[axis] ) )
+		{
+			axis = k;
+		}
+	}
+	auto coordinate = [this]( int vertex, int k )
+	{
+		return k == 0 ? points[vertex].getX() : k == 1 ? points[vertex].getY() : points[vertex].getZ();
+	};
+	int const uAxis = ( axis + 1 ) % 3;
+	int const vAxis = ( axis + 2 ) % 3;
+	auto flatTurn = [&]( int p1, int p2, int p3 )
+	{
+		long long const ux = coordinate( p2, uAxis ) - (long long) coordinate( p1, uAxis );
+		long long const uy = coordinate( p2, vAxis ) - (long long) coordinate( p1, vAxis );
+		long long const vx = coordinate( p3, uAxis ) - (long long) coordinate( p2, uAxis );
+		long long const vy = coordinate( p3, vAxis ) - (long long) coordinate( p2, vAxis );
+		return ux * vy - uy * vx;
+	};
+
+	std::vector<int> order( count );
+	for ( int i = 0; i < count; i++ )
+	{
+		order[i] = i;
+	}
+	std::sort( order.begin(), order.end(), [&]( int a, int b )
+	{
+		if ( coordinate( a, uAxis ) != coordinate( b, uAxis ) )
+		{
+			return coordinate( a, uAxis ) < coordinate( b, uAxis );
+		}
+		return coordinate( a, vAxis ) < coordinate( b, vAxis );
+	} );
+
+	//Lower then upper hull, keeping only right turns, as convexHull does
+	std::vector<int> polygon;
+	for ( int pass = 0; pass < 2; pass++ )
+	{
+		size_t const chainStart = polygon.size();
+		for ( int i = 0; i < count; i++ )
+		{
+			int const p = pass == 0 ? order[i] : order[count - 1 - i];
+			while ( polygon.size() >= chainStart + 2 && flatTurn( polygon[polygon.size() - 2], polygon.back(), p ) <= 0 )
+			{
+				polygon.pop_back();
+			}
+			polygon.push_back( p );
+		}
+		polygon.pop_back();
+	}
+	if ( normal[axis] < 0 )
+	{
+		std::reverse( polygon.begin(), polygon.end() );
+	}
+
+	//A fan over each side. Top face i is ( 0, i, i + 1 ) round the polygon and bottom face i the same
+	//turned over; each side's diagonals pair up within it and the outline pairs up across the two
+	int const m = polygon.size();
+	for ( int i = 1; i + 1 < m; i++ )
+	{
+		addFace( polygon[0], polygon[i], polygon[i + 1] );
+		addFace( polygon[0], polygon[i + 1], polygon[i] );
+	}
+	auto link = [this]( int a, int b )
+	{
+		twins[a] = b;
+		twins[b] = a;
+	};
+	int const last = m - 3;
+	for ( int i = 0; i <= last; i++ )
+	{
+		int const top = 2 * i;
+		int const bottom = 2 * i + 1;
+		link( 3 * top + 1, 3 * bottom + 1 );
+		if ( i < last )
+		{
+			link( 3 * top + 2, 3 * ( top + 2 ) );
+			link( 3 * bottom, 3 * ( bottom + 2 ) + 2 );
+		}
+	}
+	link( 0, 3 * 1 + 2 );
+	link( 3 * ( 2 * last ) + 2, 3 * ( 2 * last + 1 ) );
+}
+
+//Add a point outside the hull: remove the faces it can see and join it to the edge round them
+void MeshBuilder::insert( int vertex, bool searchAll )
+{
+	step++;
+	int seed = -1;
+	for ( size_t i = 0; i < lastFaces.size() && !searchAll && seed < 0; i++ )
+	{
+		if ( orient( lastFaces[i], vertex ) > 0 )
+		{
+			seed = lastFaces[i];
+		}
+	}
+	for ( size_t f = 0; f < alive.size() && seed < 0; f++ )
+	{
+		if ( alive[f] && orient( f, vertex ) > 0 )
+		{
+			seed = f;
+		}
+	}
+	if ( seed < 0 )
+	{
+		return;
+	}
+
+	//Spread across the faces the point can see, and those whose plane it is on, so points left on a
+	//flat face or a straight edge go. Faces kept are then strictly beneath it, so none of the new faces
+	//can be flat, and the edges to them go round the removed faces in a loop
+	visible.clear();
+	horizon.clear();
+	stack.clear();
+	stack.push_back( seed );
+	seen[seed] = step;
+	while ( !stack.empty() )
+	{
+		int const face = stack.back();
+		stack.pop_back();
+		visible.push_back( face );
+		for ( int k = 0; k < 3; k++ )
+		{
+			int const edge = 3 * face + k;
+			int const beside = twins[edge] / 3;
+			if ( seen[beside] == step )
+			{
+				continue;
+			}
+			if ( seen[beside] != -step && orient( beside, vertex ) >= 0 )
+			{
+				seen[beside] = step;
+				stack.push_back( beside );
+			}
+			else
+			{
+				seen[beside] = -step;
+				horizon.push_back( edge );
+			}
+		}
+	}
+
+	horizonEnds.clear();
+	for ( size_t i = 0; i < horizon.size(); i++ )
+	{
+		int const edge = horizon[i];
+		horizonEnds.push_back( origins[edge] );
+		horizonEnds.push_back( origins[edge % 3 == 2 ? edge - 2 : edge + 1] );
+		horizonEnds.push_back( twins[edge] );
+	}
+	for ( size_t i = 0; i < visible.size(); i++ )
+	{
+		alive[visible[i]] = false;
+		freeFaces.push_back( visible[i] );
+	}
+
+	//A new face on each horizon edge, running the same way round as the face it replaces
+	lastFaces.clear();
+	for ( size_t i = 0; i < horizonEnds.size(); i += 3 )
+	{
+		int const face = addFace( horizonEnds[i], horizonEnds[i + 1], vertex );
+		twins[3 * face] = horizonEnds[i + 2];
+		twins[horizonEnds[i + 2]] = 3 * face;
+		startFace[horizonEnds[i]] = face;
+		lastFaces.push_back( face );
+	}
+	//Then stitch neighbouring new faces together along their edges to the new point
+	for ( size_t i = 0; i < lastFaces.size(); i++ )
+	{
+		int const face = lastFaces[i];
+		int const after = startFace[origins[3 * face + 1]];
+		twins[3 * face + 1] = 3 * after + 2;
+		twins[3 * after + 2] = 3 * face + 1;
+	}
+}
+
+//Drop removed faces and the points no face uses, keeping the points in order
+HullMesh MeshBuilder::compact()
+{
+	std::vector<int> vertexIndex( points.size(), -1 );
+	std::vector<int> faceIndex( alive.size(), -1 );
+	int nFaces = 0;
+	for ( size_t f = 0; f < alive.size(); f++ )
+	{
+		if ( alive[f] )
+		{
+			faceIndex[f] = nFaces++;
+			for ( int k = 0; k < 3; k++ )
+			{
+				vertexIndex[origins[3 * f + k]] = 0;
+			}
+		}
+	}
+
+	HullMesh mesh;
+	for ( size_t v = 0; v < points.size(); v++ )
+	{
+		if ( vertexIndex[v] == 0 )
+		{
+			vertexIndex[v] = mesh.vertices.size();
+			mesh.vertices.push_back( points[v] );
+		}
+	}
+	mesh.origins.resize( 3 * nFaces );
+	mesh.twins.resize( 3 * nFaces );
+	for ( size_t f = 0; f < alive.size(); f++ )
+	{
+		if ( alive[f] )
+		{
+			for ( int k = 0; k < 3; k++ )
+			{
+				int const twin = twins[3 * f + k];
+				mesh.origins[3 * faceIndex[f] + k] = vertexIndex[origins[3 * f + k]];
+				mesh.twins[3 * faceIndex[f] + k] = 3 * faceIndex[twin / 3] + twin % 3;
+			}
+		}
+	}
+	return mesh;
+}
+
+HullMesh hull3( std::vector<Point3> sortedPoints )
+{
+	return hull3( sortedPoints, 0, sortedPoints.size() );
+}
+
+HullMesh hull3( std::vector<Point3>& sortedPoints, size_t begin, size_t end )
+{
+	MeshBuilder builder( sortedPoints.data() + begin, sortedPoints.data() + end );
+	return builder.build();
+}
+
+//Sign of ux * vy - uy * vx, for differences of coordinates, where the products can reach 2^62
+static int crossSign( long long ux, long long uy, long long vx, long long vy )
+{
+	unsigned long long hi = 0;
+	unsigned long long lo = 0;
+	addProduct( ux, vy, hi, lo );
+	addProduct( -uy, vx, hi, lo );
+	return sign128( hi, lo );
+}
+
+//Whether the mesh has faces and a vertex off the plane of its first one
+static bool hasVolume( const HullMesh& mesh )
+{
+	if ( mesh.getFaceCount() == 0 )
+	{
+		return false;
+	}
+	const Point3& a = mesh.vertices[mesh.origins[0]];
+	const Point3& b = mesh.vertices[mesh.origins[1]];
+	const Point3& c = mesh.vertices[mesh.origins[2]];
+	for ( size_t v = 0; v < mesh.vertices.size(); v++ )
+	{
+		if ( orientation( a, b, c, mesh.vertices[v] ) != 0 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//Joins the hulls of two point sets, every point of the left one before every point of the right one
+//with no x in both, without hulling their vertices again (Preparata and Hong). From an edge joining
+//the two, a band of faces is wrapped round between them one face at a time, each on an edge of one
+//hull at the band's current end and a vertex of the other; then the faces the band closes off go.
+//Each step looks at the neighbours of the band's two current ends, unless the new face lies flat
+//against other points, when every vertex is looked at to find the corners of that plane
+class MeshStitcher
+{
+public:
+	MeshStitcher( const HullMesh& left, const HullMesh& right );
+	bool stitch( HullMesh& merged );
+
+private:
+	static int next( int edge );
+	int orient( int a, int b, int c, int d ) const;
+	bool onOneLine( int a, int b, int c ) const;
+	bool further( int from, int than, int p ) const;
+	int edgeTo( int from, int to ) const;
+	void addFace( int a, int b, int c );
+	void link( int a, int b );
+	bool firstRung( int& a, int& b ) const;
+	int apex( int a, int b, int& rim );
+	int flatApex( int a, int b, int onPlane, int& rim );
+	int flatCorner( int pivot, int start, bool after, int below ) const;
+	bool closeOff( const std::vector<int>& rims, int firstBand );
+	HullMesh compact() const;
+
+	//Both hulls as one mesh: left's vertices, which are all before right's, then right's, and the same
+	//for faces. Band faces go on the end
+	std::vector<Point3> points;
+	std::vector<int> origins;
+	std::vector<int> twins;
+	std::vector<bool> alive;
+	int nLeft;
+	int nLeftFaces;
+	int nOldEdges;
+	//A half-edge leaving each vertex, for walking round it
+	std::vector<int> leaving;
+
+	//Scratch for apex(): the ends' neighbours, and the half-edge a face on each would run along
+	std::vector<int> candidates;
+	std::vector<int> candidateRims;
+	//Scratch for flatApex(): vertices on the new face's plane, ahead of the band
+	std::vector<int> flat;
+};
+
+MeshStitcher::MeshStitcher( const HullMesh& left, const HullMesh& right )
+{
+	nLeft = left.vertices.size();
+	nLeftFaces = left.getFaceCount();
+	points = left.vertices;
+	points.insert( points.end(), right.vertices.begin(), right.vertices.end() );
+	origins = left.origins;
+	twins = left.twins;
+	int const leftEdges = left.origins.size();
+	for ( size_t e = 0; e < right.origins.size(); e++ )
+	{
+		origins.push_back( right.origins[e] + nLeft );
+		twins.push_back( right.twins[e] + leftEdges );
+	}
+	nOldEdges = origins.size();
+	alive.assign( nOldEdges / 3, true );
+
+	leaving.assign( points.size(), -1 );
+	for ( int e = 0; e < nOldEdges; e++ )
+	{
+		leaving[origins[e]] = e;
+	}
+}
+
+int MeshStitcher::next( int edge )
+{
+	return edge % 3 == 2 ? edge - 2 : edge + 1;
+}
+
+int MeshStitcher::orient( int a, int b, int c, int d ) const
+{
+	return orientation( points[a], points[b], points[c], points[d] );
+}
+
+bool MeshStitcher::onOneLine( int a, int b, int c ) const
+{
+	long long const abx = points[b].getX() - (long long) points[a].getX();
+	long long const aby = points[b].getY() - (long long) points[a].getY();
+	long long const abz = points[b].getZ() - (long long) points[a].getZ();
+	long long const acx = points[c].getX() - (long long) points[a].getX();
+	long long const acy = points[c].getY() - (long long) points[a].getY();
+	long long const acz = points[c].getZ() - (long long) points[a].getZ();
+	return aby * acz == abz * acy && abz * acx == abx * acz && abx * acy == aby * acx;
+}
+
+//For p on the line from from through than: whether p is further along it than than
+bool MeshStitcher::further( int from, int than, int p ) const
+{
+	unsigned long long hi = 0;
+	unsigned long long lo = 0;
+	addProduct( points[p].getX() - (long long) points[than].getX(), points[than].getX() - (long long) points[from].getX(), hi, lo );
+	addProduct( points[p].getY() - (long long) points[than].getY(), points[than].getY() - (long long) points[from].getY(), hi, lo );
+	addProduct( points[p].getZ() - (long long) points[than].getZ(), points[than].getZ() - (long long) points[from].getZ(), hi, lo );
+	return sign128( hi, lo ) > 0;
+}
+
+//The half-edge from one vertex to another, or -1 if they aren't neighbours
+int MeshStitcher::edgeTo( int from, int to ) const
+{
+	int const first = leaving[from];
+	int edge = first;
+	do
+	{
+		if ( origins[twins[edge]] == to )
+		{
+			return edge;
+		}
+		edge = next( twins[edge] );
+	} while ( edge != first );
+	return -1;
+}
+
+void MeshStitcher::addFace( int a, int b, int c )
+{
+	origins.push_back( a );
+	origins.push_back( b );
+	origins.push_back( c );
+	twins.resize( origins.size(), -1 );
+	alive.push_back( true );
+}
+
+void MeshStitcher::link( int a, int b )
+{
+	twins[a] = b;
+	twins[b] = a;
+}
+
+//An edge of the joined hull from a left vertex to a right one. Seen from above, the outline's lower
+//side crosses from left to right along one edge, and the upright plane through it touches the joined
+//hull along a face or edge. That face's outline, seen side on, crosses over on one of its own edges
+bool MeshStitcher::firstRung( int& a, int& b ) const
+{
+	//Lower side of the outline, keeping only left turns, as convexHull does, with points in order
+	//so by x then y
+	auto lowerCrossing = [this]( const std::vector<int>& order, bool sideOn, int& from, int& to )
+	{
+		auto turn = [&]( int p, int q, int r )
+		{
+			long long const uy = sideOn ? points[q].getZ() - (long long) points[p].getZ() : points[q].getY() - (long long) points[p].getY();
+			long long const vy = sideOn ? points[r].getZ() - (long long) points[p].getZ() : points[r].getY() - (long long) points[p].getY();
+			return crossSign( points[q].getX() - (long long) points[p].getX(), uy, points[r].getX() - (long long) points[p].getX(), vy );
+		};
+		std::vector<int> chain;
+		for ( size_t i = 0; i < order.size(); i++ )
+		{
+			while ( chain.size() >= 2 && turn( chain[chain.size() - 2], chain.back(), order[i] ) <= 0 )
+			{
+				chain.pop_back();
+			}
+			chain.push_back( order[i] );
+		}
+		for ( size_t i = 0; i + 1 < chain.size(); i++ )
+		{
+			if ( chain[i] < nLeft && chain[i + 1] >= nLeft )
+			{
+				from = chain[i];
+				to = chain[i + 1];
+				return true;
+			}
+		}
+		return false;
+	};
+
+	std::vector<int> order( points.size() );
+	for ( size_t v = 0; v < points.size(); v++ )
+	{
+		order[v] = v;
+	}
+	int p;
+	int q;
+	if ( !lowerCrossing( order, false, p, q ) )
+	{
+		return false;
+	}
+
+	//Left's x are all below right's, so the line from p to q isn't parallel to the y axis, and points
+	//on it are in order by x then z
+	std::vector<int> onPlane;
+	long long const dx = points[q].getX() - (long long) points[p].getX();
+	long long const dy = points[q].getY() - (long long) points[p].getY();
+	for ( size_t v = 0; v < points.size(); v++ )
+	{
+		if ( crossSign( dx, dy, points[v].getX() - (long long) points[p].getX(), points[v].getY() - (long long) points[p].getY() ) == 0 )
+		{
+			onPlane.push_back( v );
+		}
+	}
+	return lowerCrossing( onPlane, true, a, b );
+}
+
+//Next face of the band ( a, apex, b ), with a a left vertex and b a right one, beyond the edge from b
+//to a. Sets rim to the half-edge of the old meshes that the face's first edge runs along. -1 if
+//there's no such face
+int MeshStitcher::apex( int a, int b, int& rim )
+{
+	//A plane through a with all a's neighbours beneath it has all of left beneath, and the same for b
+	//and right, so only neighbours of the ends are looked at. A left one makes the face ( a, c, b ) on
+	//left's edge from a to c, a right one the face ( c, b, a ) on right's edge from c to b
+	candidates.clear();
+	candidateRims.clear();
+	for ( int end = 0; end < 2; end++ )
+	{
+		int const first = leaving[end == 0 ? a : b];
+		int edge = first;
+		do
+		{
+			int const c = origins[twins[edge]];
+			if ( !onOneLine( a, b, c ) )
+			{
+				candidates.push_back( c );
+				candidateRims.push_back( end == 0 ? edge : twins[edge] );
+			}
+			edge = next( twins[edge] );
+		} while ( edge != first );
+	}
+	if ( candidates.empty() )
+	{
+		return -1;
+	}
+
+	//Wrap a plane round the line through a and b, from the last face, until nothing is outside it.
+	//A point on the last face's plane behind the band and one on it ahead are level with each other,
+	//so one pass may stop at the one behind; go round again until nothing changes
+	size_t best = 0;
+	bool moved = true;
+	while ( moved )
+	{
+		moved = false;
+		for ( size_t i = 0; i < candidates.size(); i++ )
+		{
+			if ( orient( a, candidates[best], b, candidates[i] ) > 0 )
+			{
+				best = i;
+				moved = true;
+			}
+		}
+	}
+	int onPlane = 0;
+	for ( size_t i = 0; i < candidates.size(); i++ )
+	{
+		if ( orient( a, candidates[best], b, candidates[i] ) == 0 )
+		{
+			onPlane++;
+		}
+	}
+	if ( onPlane == 1 )
+	{
+		rim = candidateRims[best];
+		return candidates[best];
+	}
+	return flatApex( a, b, candidates[best], rim );
+}
+
+//apex() when other points share the plane of the face it found: the face must take a corner of the
+//polygon they make, which may not be a neighbour it looked at, and only on the band's side of a to b
+int MeshStitcher::flatApex( int a, int b, int onPlane, int& rim )
+{
+	int below = -1;
+	flat.clear();
+	for ( int v = 0; v < (int) points.size(); v++ )
+	{
+		int const side = orient( a, onPlane, b, v );
+		if ( side < 0 && below < 0 )
+		{
+			below = v;
+		}
+		else if ( side == 0 && v != a && v != b )
+		{
+			flat.push_back( v );
+		}
+	}
+	if ( below < 0 )
+	{
+		return -1;
+	}
+	size_t kept = 0;
+	for ( size_t i = 0; i < flat.size(); i++ )
+	{
+		if ( orient( b, a, flat[i], below ) < 0 )
+		{
+			flat[kept++] = flat[i];
+		}
+	}
+	flat.resize( kept );
+
+	//The polygon goes round from b to a, on to the corner after a, and back to b from the corner
+	//before b. Left's corners come together and so do right's, so either the corner before b is
+	//right's, and an edge of right's hull, or the corner after a is left's, and an edge of left's
+	int const beforeB = flatCorner( b, a, false, below );
+	if ( beforeB >= nLeft )
+	{
+		int const edge = edgeTo( b, beforeB );
+		rim = edge < 0 ? -1 : twins[edge];
+		return edge < 0 ? -1 : beforeB;
+	}
+	int const afterA = flatCorner( a, b, true, below );
+	if ( afterA < nLeft )
+	{
+		rim = edgeTo( a, afterA );
+		return rim < 0 ? -1 : afterA;
+	}
+	return -1;
+}
+
+//Corner of the polygon round flat, pivot and start, with below beneath its plane, that comes after
+//pivot going round from start (or before pivot, going back from start). Of several on one line from
+//pivot, the furthest, since the nearer ones aren't corners
+int MeshStitcher::flatCorner( int pivot, int start, bool after, int below ) const
+{
+	int best = start;
+	for ( size_t i = 0; i < flat.size(); i++ )
+	{
+		int const side = after ? orient( pivot, best, flat[i], below ) : orient( best, pivot, flat[i], below );
+		if ( side > 0 || ( side == 0 && further( pivot, best, flat[i] ) ) )
+		{
+			best = flat[i];
+		}
+	}
+	return best;
+}
+
+//Remove the old faces the band closes off, and join the band to what is left. rims holds the old
+//half-edge each band face runs along, from firstBand on. Faces on the band's side of those edges go,
+//and so does the rest of their connected region; a hull the band only touches at one vertex goes
+//whole. An edge can have band faces on both sides, when no face either side of it stays
+bool MeshStitcher::closeOff( const std::vector<int>& rims, int firstBand )
+{
+	std::vector<int> bandEdge( nOldEdges, -1 );
+	std::vector<int> stack;
+	bool touches[2] = { false, false };
+	for ( size_t i = 0; i < rims.size(); i++ )
+	{
+		bandEdge[rims[i]] = 3 * ( firstBand + i );
+		touches[rims[i] / 3 >= nLeftFaces] = true;
+		if ( alive[rims[i] / 3] )
+		{
+			alive[rims[i] / 3] = false;
+			stack.push_back( rims[i] / 3 );
+		}
+	}
+	int const nOldFaces = nOldEdges / 3;
+	for ( int f = 0; f < nOldFaces; f++ )
+	{
+		if ( !touches[f >= nLeftFaces] )
+		{
+			alive[f] = false;
+		}
+	}
+	while ( !stack.empty() )
+	{
+		int const face = stack.back();
+		stack.pop_back();
+		for ( int k = 0; k < 3; k++ )
+		{
+			int const edge = 3 * face + k;
+			int const beside = twins[edge] / 3;
+			if ( bandEdge[edge] < 0 && bandEdge[twins[edge]] < 0 && alive[beside] )
+			{
+				alive[beside] = false;
+				stack.push_back( beside );
+			}
+		}
+	}
+
+	for ( size_t i = 0; i < rims.size(); i++ )
+	{
+		int const across = twins[rims[i]];
+		if ( alive[across / 3] )
+		{
+			link( 3 * ( firstBand + i ), across );
+		}
+		else if ( bandEdge[across] >= 0 )
+		{
+			link( 3 * ( firstBand + i ), bandEdge[across] );
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	//Every face left must now border only faces left
+	for ( size_t f = 0; f < alive.size(); f++ )
+	{
+		for ( int k = 0; k < 3 && alive[f]; k++ )
+		{
+			int const twin = twins[3 * f + k];
+			if ( twin < 0 || !alive[twin / 3] || twins[twin] != (int) ( 3 * f + k ) || origins[twin] != origins[next( 3 * f + k )] )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//Drop removed faces and the points no face uses, keeping the points in order
+HullMesh MeshStitcher::compact() const
+{
+	std::vector<int> vertexIndex( points.size(), -1 );
+	std::vector<int> faceIndex( alive.size(), -1 );
+	int nFaces = 0;
+	for ( size_t f = 0; f < alive.size(); f++ )
+	{
+		if ( alive[f] )
+		{
+			faceIndex[f] = nFaces++;
+			for ( int k = 0; k < 3; k++ )
+			{
+				vertexIndex[origins[3 * f + k]] = 0;
+			}
+		}
+	}
+
+	HullMesh mesh;
+	for ( size_t v = 0; v < points.size(); v++ )
+	{
+		if ( vertexIndex[v] == 0 )
+		{
+			vertexIndex[v] = mesh.vertices.size();
+			mesh.vertices.push_back( points[v] );
+		}
+	}
+	mesh.origins.resize( 3 * nFaces );
+	mesh.twins.resize( 3 * nFaces );
+	for ( size_t f = 0; f < alive.size(); f++ )
+	{
+		if ( alive[f] )
+		{
+			for ( int k = 0; k < 3; k++ )
+			{
+				int const twin = twins[3 * f + k];
+				mesh.origins[3 * faceIndex[f] + k] = vertexIndex[origins[3 * f + k]];
+				mesh.twins[3 * faceIndex[f] + k] = 3 * faceIndex[twin / 3] + twin % 3;
+			}
+		}
+	}
+	return mesh;
+}
+
+//Returns false, leaving merged alone, if the band can't be found or doesn't close up
+bool MeshStitcher::stitch( HullMesh& merged )
+{
+	int a0;
+	int b0;
+	if ( !firstRung( a0, b0 ) )
+	{
+		return false;
+	}
+
+	//Each band face runs along its own old half-edge, so there are no more of them than that. Each
+	//face's second and third edges lead on to the next face and back to the last, in one order for a
+	//face on a left edge and the other for one on a right edge
+	int const firstBand = nOldEdges / 3;
+	std::vector<int> rims;
+	std::vector<bool> used( nOldEdges, false );
+	int a = a0;
+	int b = b0;
+	int firstBack = -1;
+	int lastForward = -1;
+	do
+	{
+		int rim = -1;
+		int const c = apex( a, b, rim );
+		if ( c < 0 || rim < 0 || used[rim] || (int) rims.size() == nOldEdges )
+		{
+			return false;
+		}
+		used[rim] = true;
+		rims.push_back( rim );
+
+		int const face = origins.size() / 3;
+		int back;
+		int forward;
+		if ( c < nLeft )
+		{
+			addFace( a, c, b );
+			forward = 3 * face + 1;
+			back = 3 * face + 2;
+			a = c;
+		}
+		else
+		{
+			addFace( c, b, a );
+			back = 3 * face + 1;
+			forward = 3 * face + 2;
+			b = c;
+		}
+		if ( lastForward < 0 )
+		{
+			firstBack = back;
+		}
+		else
+		{
+			link( lastForward, back );
+		}
+		lastForward = forward;
+	} while ( a != a0 || b != b0 );
+	link( lastForward, firstBack );
+
+	if ( !closeOff( rims, firstBand ) )
+	{
+		return false;
+	}
+	merged = compact();
+	return true;
+}
+
+HullMesh shardedHull3( std::vector<Point3>& sortedPoints, size_t nShards )
+{
+	//Shards smaller than this cost more in thread start-up than they save
+	size_t const minShardSize = 1 << 12;
+	size_t const n = sortedPoints.size();
+
+	std::vector<size_t> bounds;
+	bounds.push_back( 0 );
+	for ( size_t s = 1; s < nShards; s++ )
+	{
+		//Pushed forward so no x is in two shards, which keeps neighbouring partial hulls apart
+		size_t b = std::max( n * s / nShards, bounds.back() );
+		while ( b > 0 && b < n && sortedPoints.at( b ).getX() == sortedPoints.at( b - 1 ).getX() )
+		{
+			b++;
+		}
+		if ( b - bounds.back() >= minShardSize && n - b >= minShardSize )
+		{
+			bounds.push_back( b );
+		}
+	}
+	bounds.push_back( n );
+
+	//Run work( 0 ) to work( count - 1 ) each on its own thread (the calling thread takes the first)
+	auto inParallel = []( size_t count, std::function<void( size_t )> work )
+	{
+		std::vector<std::thread> workers;
+		for ( size_t i = 1; i < count; i++ )
+		{
+			workers.push_back( std::thread( work, i ) );
+		}
+		work( 0 );
+		for ( size_t i = 0; i < workers.size(); i++ )
+		{
+			workers.at( i ).join();
+		}
+	};
+
+	std::vector<HullMesh> partialHulls( bounds.size() - 1 );
+	inParallel( partialHulls.size(), [&]( size_t s )
+	{
+		partialHulls.at( s ) = hull3( sortedPoints, bounds.at( s ), bounds.at( s + 1 ) );
+	} );
+
+	//Stitch neighbouring pairs of partial hulls together until one hull is left
+	while ( partialHulls.size() > 1 )
+	{
+		std::vector<HullMesh> merged( ( partialHulls.size() + 1 ) / 2 );
+		inParallel( merged.size(), [&]( size_t s )
+		{
+			if ( 2 * s + 1 == partialHulls.size() )
+			{
+				merged.at( s ) = std::move( partialHulls.at( 2 * s ) );
+				return;
+			}
+			const HullMesh& left = partialHulls.at( 2 * s );
+			const HullMesh& right = partialHulls.at( 2 * s + 1 );
+			if ( hasVolume( left ) && hasVolume( right ) )
+			{
+				MeshStitcher stitcher( left, right );
+				if ( stitcher.stitch( merged.at( s ) ) )
+				{
+					return;
+				}
+			}
+			//A flat or straight partial hull has no sides to stitch to, so hull the two again. Their points,
+			//one after the other, are still sorted
+			std::vector<Point3> both = left.vertices;
+			both.insert( both.end(), right.vertices.begin(), right.vertices.end() );
+			merged.at( s ) = hull3( both, 0, both.size() );
+		} );
+		partialHulls = std::move( merged );
+	}
+
+	return partialHulls.at( 0 );
+}
+
+void benchmarkHull3( size_t nPoints, size_t maxShards )
+{
+	//Random points in a thick spherical shell, like a scan of a rounded object
+	std::mt19937 rng( 1 );
+	std::normal_distribution<double> direction( 0, 1 );
+	std::uniform_real_distribution<double> depth( 0.9, 1 );
+	double const radius = 1 << 20;
+
+	std::vector<Point3> sortedPoints;
+	sortedPoints.reserve( nPoints );
+	while ( sortedPoints.size() < nPoints )
+	{
+		double const x = direction( rng );
+		double const y = direction( rng );
+		double const z = direction( rng );
+		double const length = std::sqrt( x * x + y * y + z * z );
+		if ( length == 0 )
+		{
+			continue;
+		}
+		double const scale = radius * depth( rng ) / length;
+		sortedPoints.push_back( Point3( (int) ( x * scale ), (int) ( y * scale ), (int) ( z * scale ) ) );
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::sort( sortedPoints.begin(), sortedPoints.end(), wayToSort3 );
+	double const sortMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	HullMesh mesh = hull3( sortedPoints, 0, sortedPoints.size() );
+	double const baseline = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	std::cout << "hull3: " << nPoints << " points (sorted in " << sortMs << " ms), " << mesh.vertices.size() << " on hull, " << mesh.getFaceCount() << " faces, " << baseline << " ms" << std::endl;
+
+	for ( size_t nShards = 1; nShards <= maxShards; nShards *= 2 )
+	{
+		start = std::chrono::steady_clock::now();
+		mesh = shardedHull3( sortedPoints, nShards );
+		double const elapsed = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+		std::cout << "shardedHull3: " << nShards << " shards, " << mesh.vertices.size() << " on hull, " << elapsed << " ms (x" << baseline / elapsed << ")" << std::endl;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Point3.h"
+
+#include <vector>
+#include <cstddef>
+
+//Triangulated hull surface as half-edges. Face f is half-edges 3f, 3f + 1 and 3f + 2, going round it
+//so the face turns right (as rightTurn) seen from outside, which means the next half-edge never
+//needs storing. Vertices are in wayToSort3 order
+struct HullMesh
+{
+	std::vector<Point3> vertices;
+	//Index into vertices of the point each half-edge starts from
+	std::vector<int> origins;
+	//The half-edge running the other way along the same edge, in the neighbouring face
+	std::vector<int> twins;
+
+	int getFaceCount() const;
+	//Half-edge after edge round its face
+	int getNext( int edge ) const;
+};
+
+//===========================================//
+//==================HULL 3D==================//
+//sort by x coordinate then y coordinate then z coordinate
+bool wayToSort3( const Point3& a, const Point3& b );
+//Which side of the plane through a, b and c the point d is on (> 0 the side a, b, c turn right seen
+//from, 0 on the plane, < 0 the other side). Exact, with a quick check in doubles first
+int orientation( const Point3& a, const Point3& b, const Point3& c, const Point3& d );
+
+//Convex hull of sorted points, adding them in order. Flat point sets give both sides of a polygon,
+//collinear ones just the two end points. Usually close to linear after the sort, but O(n^2) at
+//worst, when each point added sees most of the hull so far
+HullMesh hull3( std::vector<Point3> sortedPoints );
+//Convex hull of sortedPoints[begin, end)
+HullMesh hull3( std::vector<Point3>& sortedPoints, size_t begin, size_t end );
+//Split sortedPoints into nShards slabs, no x in two, hull each on its own thread, then stitch
+//neighbouring pairs of partial hulls together, in parallel, until one is left. A stitch works
+//along the band between the two hulls rather than hulling their vertices again, except when one
+//of them is flat.
+//Only the slab hulls are sure to scale with cores: the last stitch runs on one thread, and the
+//caller's sort is serial. It has only been measured on one core (HULL3BENCH), where it runs
+//about as fast as hull3
+HullMesh shardedHull3( std::vector<Point3>& sortedPoints, size_t nShards );
+//Time hull3 against shardedHull3 with 1 to maxShards shards on nPoints random points in a shell
+void benchmarkHull3( size_t nPoints, size_t maxShards );
+//==================HULL 3D==================//
+//===========================================//
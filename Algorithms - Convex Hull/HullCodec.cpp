@@ -0,0 +1,270 @@
+#include "HullCodec.h"
+#include "ConvexHull.h"
+
+#include <algorithm>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <utility>
+#include <climits>
+
+//Bytes gathered before writing, and read at a time
+static size_t const bufferSize = 1 << 16;
+//Most bytes a point can take: two 64-bit varints
+static size_t const maxPointBytes = 20;
+
+//Interleave signs so values near zero, either side, become small: 0, -1, 1, -2, 2 -> 0, 1, 2, 3, 4
+static unsigned long long zigzag( long long value )
+{
+	return ( (unsigned long long) value << 1 ) ^ (unsigned long long) ( value >> 63 );
+}
+
+static long long unzigzag( unsigned long long value )
+{
+	return (long long) ( value >> 1 ) ^ -(long long) ( value & 1 );
+}
+
+HullWriter::HullWriter( std::ostream& out ) : out( out ), buffer( bufferSize ), used( 0 ), flushed( 0 ), writeFailed( false )
+{
+}
+
+HullWriter::~HullWriter()
+{
+	flush();
+}
+
+void HullWriter::putVarint( unsigned long long value )
+{
+	while ( value >= 0x80 )
+	{
+		buffer[used++] = (unsigned char) ( value | 0x80 );
+		value >>= 7;
+	}
+	buffer[used++] = (unsigned char) value;
+}
+
+void HullWriter::write( const Polygon& hull )
+{
+	PointView const points = hull.getView();
+	if ( used + maxPointBytes > bufferSize )
+	{
+		flush();
+	}
+	putVarint( points.size() );
+
+	long long lastX = 0;
+	long long lastY = 0;
+	for ( const Point& p : points )
+	{
+		if ( used + maxPointBytes > bufferSize )
+		{
+			flush();
+		}
+		putVarint( zigzag( p.getX() - lastX ) );
+		putVarint( zigzag( p.getY() - lastY ) );
+		lastX = p.getX();
+		lastY = p.getY();
+	}
+}
+
+void HullWriter::write( const std::vector<Polygon>& hulls )
+{
+	for ( size_t i = 0; i < hulls.size(); i++ )
+	{
+		write( hulls.at( i ) );
+	}
+}
+
+void HullWriter::flush()
+{
+	if ( used == 0 )
+	{
+		return;
+	}
+	out.write( (const char*) buffer.data(), used );
+	if ( !out )
+	{
+		writeFailed = true;
+	}
+	flushed += used;
+	used = 0;
+}
+
+size_t HullWriter::getBytes() const
+{
+	return flushed + used;
+}
+
+bool HullWriter::failed() const
+{
+	return writeFailed;
+}
+
+HullReader::HullReader( std::istream& in ) : in( in ), buffer( bufferSize ), position( 0 ), filled( 0 ), readFailed( false )
+{
+}
+
+HullReader::~HullReader()
+{
+}
+
+//Move what is left to the front and read up to a full buffer behind it. Returns false if nothing new was read
+bool HullReader::refill()
+{
+	std::copy( buffer.begin() + position, buffer.begin() + filled, buffer.begin() );
+	filled -= position;
+	position = 0;
+	in.read( (char*) buffer.data() + filled, bufferSize - filled );
+	size_t const got = (size_t) in.gcount();
+	filled += got;
+	return got > 0;
+}
+
+bool HullReader::getVarint( unsigned long long& value )
+{
+	value = 0;
+	for ( int shift = 0; shift < 64; shift += 7 )
+	{
+		if ( position == filled && !refill() )
+		{
+			return false;
+		}
+		unsigned char const byte = buffer[position++];
+		value |= (unsigned long long) ( byte & 0x7f ) << shift;
+		if ( byte < 0x80 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//Apply the next zigzagged step to a coordinate. Returns false if the step or the result isn't
+//something HullWriter could have written from int coordinates
+bool HullReader::getCoordinate( long long& value )
+{
+	unsigned long long encoded;
+	if ( !getVarint( encoded ) )
+	{
+		return false;
+	}
+	//Two ints are never more than 2^32 apart, and checking the step first keeps the sum from overflowing
+	long long const step = unzigzag( encoded );
+	if ( step < -( 1LL << 32 ) || step > ( 1LL << 32 ) )
+	{
+		return false;
+	}
+	value += step;
+	return value >= INT_MIN && value <= INT_MAX;
+}
+
+bool HullReader::read( Polygon& hull )
+{
+	if ( readFailed || ( position == filled && !refill() ) )
+	{
+		return false;
+	}
+	unsigned long long count;
+	if ( !getVarint( count ) )
+	{
+		readFailed = true;
+		return false;
+	}
+
+	std::vector<Point> points;
+	//A corrupt count shouldn't reserve gigabytes, so only trust it up to what a buffer could hold
+	points.reserve( (size_t) std::min<unsigned long long>( count, bufferSize ) );
+	long long x = 0;
+	long long y = 0;
+	for ( unsigned long long i = 0; i < count; i++ )
+	{
+		if ( !getCoordinate( x ) || !getCoordinate( y ) )
+		{
+			readFailed = true;
+			return false;
+		}
+		points.push_back( Point( (int) x, (int) y ) );
+	}
+	hull = Polygon( std::move( points ) );
+	return true;
+}
+
+std::vector<Polygon> HullReader::readAll()
+{
+	std::vector<Polygon> hulls;
+	Polygon hull;
+	while ( read( hull ) )
+	{
+		hulls.push_back( std::move( hull ) );
+	}
+	return hulls;
+}
+
+bool HullReader::failed() const
+{
+	return readFailed;
+}
+
+void benchmarkHullCodec( size_t nHulls )
+{
+	//Hulls of random points in discs across a large area, a few dozen points each
+	std::mt19937 rng( 1 );
+	std::uniform_int_distribution<int> centre( 0, 1 << 28 );
+	std::uniform_real_distribution<double> unit( 0, 1 );
+	std::vector<Polygon> hulls;
+	hulls.reserve( nHulls );
+	size_t nPoints = 0;
+	for ( size_t h = 0; h < nHulls; h++ )
+	{
+		int const cx = centre( rng );
+		int const cy = centre( rng );
+		std::vector<Point> points;
+		for ( int i = 0; i < 200; i++ )
+		{
+			double const angle = 6.283185307179586 * unit( rng );
+			double const radius = 10000 * std::sqrt( unit( rng ) );
+			points.push_back( Point( cx + (int) ( radius * std::cos( angle ) ), cy + (int) ( radius * std::sin( angle ) ) ) );
+		}
+		std::sort( points.begin(), points.end(), wayToSort );
+		hulls.push_back( dcHull( points ) );
+		nPoints += hulls.back().getSize();
+	}
+
+	//Text: toString() into a string instead of the console, so only formatting and flushing are timed
+	std::ostringstream text;
+	std::streambuf* const console = std::cout.rdbuf( text.rdbuf() );
+	auto start = std::chrono::steady_clock::now();
+	for ( size_t h = 0; h < nHulls; h++ )
+	{
+		hulls.at( h ).toString();
+	}
+	double const textMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	std::cout.rdbuf( console );
+	size_t const textBytes = text.str().size();
+
+	std::stringstream binary( std::ios::in | std::ios::out | std::ios::binary );
+	start = std::chrono::steady_clock::now();
+	size_t binaryBytes;
+	{
+		HullWriter writer( binary );
+		writer.write( hulls );
+		writer.flush();
+		binaryBytes = writer.getBytes();
+	}
+	double const writeMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	start = std::chrono::steady_clock::now();
+	HullReader reader( binary );
+	std::vector<Polygon> const readBack = reader.readAll();
+	double const readMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	bool same = !reader.failed() && readBack.size() == hulls.size();
+	for ( size_t h = 0; same && h < nHulls; h++ )
+	{
+		same = readBack.at( h ).getPoints() == hulls.at( h ).getPoints();
+	}
+
+	std::cout << "HullCodec: " << nHulls << " hulls, " << nPoints << " points" << std::endl;
+	std::cout << "text " << textBytes << " bytes in " << textMs << " ms, binary " << binaryBytes << " bytes in " << writeMs << " ms, read back in " << readMs << " ms" << ( same ? "" : " (MISMATCH)" ) << std::endl;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+
+#include <vector>
+#include <iostream>
+
+//Writes polygons to a binary stream. Each polygon is its point count and then each point as the
+//change from the one before (the first from 0, 0), zigzagged so small negative steps stay small and
+//stored 7 bits a byte. Neighbouring hull points are close, so most take a few bytes instead of
+//a line of text. Output is gathered in a buffer and written in large blocks. Every polygon stands
+//on its own, so opening a file with std::ios::app and writing more polygons extends it
+class HullWriter
+{
+public:
+	HullWriter( std::ostream& out );
+	//Flushes whatever is still buffered
+	~HullWriter();
+
+	void write( const Polygon& hull );
+	void write( const std::vector<Polygon>& hulls );
+	//Hand the buffered bytes to the stream
+	void flush();
+	//Bytes written so far, including those still buffered
+	size_t getBytes() const;
+	//Whether the stream has refused any bytes handed to it
+	bool failed() const;
+
+private:
+	void putVarint( unsigned long long value );
+
+	std::ostream& out;
+	std::vector<unsigned char> buffer;
+	size_t used;
+	size_t flushed;
+	bool writeFailed;
+};
+
+//Reads back what HullWriter wrote, a large block at a time
+class HullReader
+{
+public:
+	HullReader( std::istream& in );
+	~HullReader();
+
+	//Next polygon in the stream. Returns false at the end of the stream, or if what is left isn't a
+	//polygon HullWriter could have written (cut short, or a point outside int range), in which case
+	//failed() is set and reading stops
+	bool read( Polygon& hull );
+	//Every polygon up to the end of the stream, or up to the first bad one
+	std::vector<Polygon> readAll();
+	//Whether reading stopped at bad data rather than at the end of the stream
+	bool failed() const;
+
+private:
+	bool getVarint( unsigned long long& value );
+	bool getCoordinate( long long& value );
+	bool refill();
+
+	std::istream& in;
+	std::vector<unsigned char> buffer;
+	size_t position;
+	size_t filled;
+	bool readFailed;
+};
+
+//Time writing nHulls hulls as text with toString() against HullWriter, and reading them back
+void benchmarkHullCodec( size_t nHulls );
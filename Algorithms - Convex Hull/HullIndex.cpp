@@ -0,0 +1,342 @@
+#include "HullIndex.h"
+#include "ConvexHull.h"
+
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <utility>
+
+//Leaves hold at most this many points
+static int const leafSize = 32;
+
+//Lower and upper hull of sorted points, each keeping only right turns. The lower hull runs from the
+//leftmost point to the rightmost and the upper hull back again, so they share their end points
+static void hullChains( const Point* first, const Point* last, std::vector<Point>& lower, std::vector<Point>& upper )
+{
+	lower.clear();
+	upper.clear();
+	for ( const Point* p = first; p != last; p++ )
+	{
+		if ( !lower.empty() && lower.back() == *p )
+		{
+			continue;
+		}
+		while ( lower.size() >= 2 && !rightTurn( lower.at( lower.size() - 2 ), lower.back(), *p ) )
+		{
+			lower.pop_back();
+		}
+		lower.push_back( *p );
+	}
+	for ( const Point* p = last; p-- != first; )
+	{
+		if ( !upper.empty() && upper.back() == *p )
+		{
+			continue;
+		}
+		while ( upper.size() >= 2 && !rightTurn( upper.at( upper.size() - 2 ), upper.back(), *p ) )
+		{
+			upper.pop_back();
+		}
+		upper.push_back( *p );
+	}
+}
+
+//Hull points of sorted points, still sorted, so hulls can be merged like sorted lists
+static void sortedHull( const Point* first, const Point* last, std::vector<Point>& hull )
+{
+	std::vector<Point> lower;
+	std::vector<Point> upper;
+	hullChains( first, last, lower, upper );
+
+	hull.clear();
+	if ( upper.size() > 2 )
+	{
+		std::merge( lower.begin(), lower.end(), upper.rbegin() + 1, upper.rend() - 1, std::back_inserter( hull ), wayToSort );
+	}
+	else
+	{
+		hull = lower;
+	}
+}
+
+HullIndex::HullIndex( std::vector<Point> indexPoints )
+{
+	points = std::move( indexPoints );
+	size_t const nNodes = 4 * ( points.size() / leafSize + 1 );
+	nodes.resize( nNodes );
+	hulls.resize( nNodes );
+
+	//Enough levels of threads to keep every core busy building subtrees
+	int threadLevels = 0;
+	while ( ( 1u << threadLevels ) < std::thread::hardware_concurrency() )
+	{
+		threadLevels++;
+	}
+
+	if ( !points.empty() )
+	{
+		build( 1, 0, points.size(), threadLevels );
+	}
+}
+
+HullIndex::HullIndex()
+{
+}
+
+HullIndex::~HullIndex()
+{
+}
+
+int HullIndex::getSize()
+{
+	return points.size();
+}
+
+bool HullIndex::isLeaf( int node )
+{
+	return nodes.at( node ).last - nodes.at( node ).first <= leafSize;
+}
+
+//threadLevels is how many more levels build their two halves on separate threads
+void HullIndex::build( int node, size_t first, size_t last, int threadLevels )
+{
+	Node& n = nodes.at( node );
+	n.first = first;
+	n.last = last;
+	n.minX = n.maxX = points.at( first ).getX();
+	n.minY = n.maxY = points.at( first ).getY();
+	for ( size_t i = first + 1; i < last; i++ )
+	{
+		n.minX = std::min( n.minX, points.at( i ).getX() );
+		n.maxX = std::max( n.maxX, points.at( i ).getX() );
+		n.minY = std::min( n.minY, points.at( i ).getY() );
+		n.maxY = std::max( n.maxY, points.at( i ).getY() );
+	}
+
+	Point* const begin = points.data();
+	if ( isLeaf( node ) )
+	{
+		std::sort( begin + first, begin + last, wayToSort );
+		sortedHull( begin + first, begin + last, hulls.at( node ) );
+		return;
+	}
+
+	//Split the wider side of the box at its median
+	size_t const mid = first + ( last - first ) / 2;
+	if ( (long long) n.maxX - n.minX >= (long long) n.maxY - n.minY )
+	{
+		std::nth_element( begin + first, begin + mid, begin + last, wayToSort );
+	}
+	else
+	{
+		std::nth_element( begin + first, begin + mid, begin + last, []( const Point& a, const Point& b )
+		{
+			return a.getY() < b.getY() || ( a.getY() == b.getY() && a.getX() < b.getX() );
+		} );
+	}
+
+	if ( threadLevels > 0 )
+	{
+		std::thread leftThread( &HullIndex::build, this, 2 * node, first, mid, threadLevels - 1 );
+		build( 2 * node + 1, mid, last, threadLevels - 1 );
+		leftThread.join();
+	}
+	else
+	{
+		build( 2 * node, first, mid, 0 );
+		build( 2 * node + 1, mid, last, 0 );
+	}
+
+	//The hull of a node is the hull of its children's hulls
+	std::vector<Point> merged;
+	std::vector<Point> const& leftHull = hulls.at( 2 * node );
+	std::vector<Point> const& rightHull = hulls.at( 2 * node + 1 );
+	merged.reserve( leftHull.size() + rightHull.size() );
+	std::merge( leftHull.begin(), leftHull.end(), rightHull.begin(), rightHull.end(), std::back_inserter( merged ), wayToSort );
+	sortedHull( merged.data(), merged.data() + merged.size(), hulls.at( node ) );
+}
+
+Polygon HullIndex::query( int minX, int minY, int maxX, int maxY )
+{
+	//Hull of the points found so far, both sorted and in hull order
+	std::vector<Point> found;
+	std::vector<Point> hull;
+	std::vector<Point> lower;
+	std::vector<Point> upper;
+	std::vector<Point> scratch;
+
+	//Add points to the hull, unless they are all inside it already
+	auto addPoints = [&]( const Point* first, const Point* last )
+	{
+		scratch.clear();
+		PointView const hullView( hull.data(), hull.size() );
+		for ( const Point* p = first; p != last; p++ )
+		{
+			if ( !insideHull( hullView, *p ) )
+			{
+				scratch.push_back( *p );
+			}
+		}
+		if ( scratch.empty() )
+		{
+			return;
+		}
+
+		std::vector<Point> merged;
+		merged.reserve( found.size() + scratch.size() );
+		std::merge( found.begin(), found.end(), scratch.begin(), scratch.end(), std::back_inserter( merged ), wayToSort );
+		sortedHull( merged.data(), merged.data() + merged.size(), found );
+
+		hullChains( found.data(), found.data() + found.size(), lower, upper );
+		hull = lower;
+		for ( size_t i = 1; i + 1 < upper.size(); i++ )
+		{
+			hull.push_back( upper.at( i ) );
+		}
+	};
+
+	//Squared distance from the part of a node inside the rectangle to the nearest corner
+	auto cornerDistance = [&]( int node )
+	{
+		Node const& n = nodes.at( node );
+		long long const dx = std::min( std::max( n.minX, minX ) - (long long) minX, maxX - (long long) std::min( n.maxX, maxX ) );
+		long long const dy = std::min( std::max( n.minY, minY ) - (long long) minY, maxY - (long long) std::min( n.maxY, maxY ) );
+		return dx * dx + dy * dy;
+	};
+
+	//Go down a level at a time, nearest the corners first. The hull's points are mostly out there,
+	//so the hull grows quickly and most nodes nearer the middle turn out to be inside it
+	std::vector<int> level;
+	std::vector<int> nextLevel;
+	std::vector<std::pair<long long, int>> order;
+	if ( !points.empty() )
+	{
+		level.push_back( 1 );
+	}
+	while ( !level.empty() )
+	{
+		order.clear();
+		for ( size_t i = 0; i < level.size(); i++ )
+		{
+			order.push_back( std::make_pair( cornerDistance( level.at( i ) ), level.at( i ) ) );
+		}
+		std::sort( order.begin(), order.end() );
+
+		nextLevel.clear();
+		for ( size_t i = 0; i < order.size(); i++ )
+		{
+			int const node = order.at( i ).second;
+			Node const& n = nodes.at( node );
+
+			//Missed altogether
+			if ( n.maxX < minX || n.minX > maxX || n.maxY < minY || n.minY > maxY )
+			{
+				continue;
+			}
+
+			//The part of the box inside the rectangle is inside the hull, so nothing under it counts
+			int const left = std::max( n.minX, minX );
+			int const right = std::min( n.maxX, maxX );
+			int const bottom = std::max( n.minY, minY );
+			int const top = std::min( n.maxY, maxY );
+			PointView const hullView( hull.data(), hull.size() );
+			if ( insideHull( hullView, Point( left, bottom ) ) && insideHull( hullView, Point( right, bottom ) ) && insideHull( hullView, Point( right, top ) ) && insideHull( hullView, Point( left, top ) ) )
+			{
+				continue;
+			}
+
+			if ( n.minX >= minX && n.maxX <= maxX && n.minY >= minY && n.maxY <= maxY )
+			{
+				//Covered, so the stored hull stands in for all the node's points
+				std::vector<Point> const& nodeHull = hulls.at( node );
+				addPoints( nodeHull.data(), nodeHull.data() + nodeHull.size() );
+			}
+			else if ( isLeaf( node ) )
+			{
+				std::vector<Point> inside;
+				for ( size_t k = n.first; k < n.last; k++ )
+				{
+					Point const& p = points.at( k );
+					if ( p.getX() >= minX && p.getX() <= maxX && p.getY() >= minY && p.getY() <= maxY )
+					{
+						inside.push_back( p );
+					}
+				}
+				addPoints( inside.data(), inside.data() + inside.size() );
+			}
+			else
+			{
+				nextLevel.push_back( 2 * node );
+				nextLevel.push_back( 2 * node + 1 );
+			}
+		}
+		level.swap( nextLevel );
+	}
+
+	//found is sorted, so hull order starts at the leftmost point, as convexHull's does
+	if ( found.size() < 3 )
+	{
+		hull = found;
+	}
+	return Polygon( std::move( hull ) );
+}
+
+void benchmarkHullIndex( size_t nPoints, size_t nQueries )
+{
+	std::mt19937 rng( 1 );
+	int const range = 1 << 20;
+	std::uniform_int_distribution<int> dist( 0, range );
+
+	std::vector<Point> points;
+	points.reserve( nPoints );
+	for ( size_t i = 0; i < nPoints; i++ )
+	{
+		points.push_back( Point( dist( rng ), dist( rng ) ) );
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	HullIndex index( points );
+	double const buildMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	std::cout << "HullIndex: " << nPoints << " points, built in " << buildMs << " ms" << std::endl;
+
+	//Rectangles from a hundredth of the range across up to all of it
+	for ( int width = range / 100; width <= range; width *= 10 )
+	{
+		std::uniform_int_distribution<int> corner( 0, range - width );
+		std::vector<int> corners;
+		for ( size_t q = 0; q < 2 * nQueries; q++ )
+		{
+			corners.push_back( corner( rng ) );
+		}
+
+		size_t hullPoints = 0;
+		start = std::chrono::steady_clock::now();
+		for ( size_t q = 0; q < nQueries; q++ )
+		{
+			int const x = corners.at( 2 * q );
+			int const y = corners.at( 2 * q + 1 );
+			hullPoints += index.query( x, y, x + width, y + width ).getSize();
+		}
+		double const queryMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count() / nQueries;
+
+		//Filter, sort and dcHull, as without the index. Slow, so only once
+		start = std::chrono::steady_clock::now();
+		int const x = corners.at( 0 );
+		int const y = corners.at( 1 );
+		std::vector<Point> inside;
+		for ( size_t i = 0; i < points.size(); i++ )
+		{
+			if ( points.at( i ).getX() >= x && points.at( i ).getX() <= x + width && points.at( i ).getY() >= y && points.at( i ).getY() <= y + width )
+			{
+				inside.push_back( points.at( i ) );
+			}
+		}
+		std::sort( inside.begin(), inside.end(), wayToSort );
+		size_t const baselineSize = inside.empty() ? 0 : dcHull( inside ).getSize();
+		double const baselineMs = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+		std::cout << "width " << width << ": " << queryMs << " ms per query, " << hullPoints / nQueries << " on hull (filter + dcHull " << baselineMs << " ms, " << baselineSize << " on hull)" << std::endl;
+	}
+}
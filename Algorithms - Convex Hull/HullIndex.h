@@ -0,0 +1,44 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+
+#include <vector>
+
+//Static k-d tree over a set of points for hulls of the points inside a rectangle. Every node keeps
+//the hull of its points, so a query merges the stored hulls of the nodes the rectangle covers and
+//only opens the nodes its edges cut through. Nodes already inside the hull found so far are skipped
+class HullIndex
+{
+public:
+	HullIndex( std::vector<Point> indexPoints );
+	HullIndex();
+	~HullIndex();
+
+	//Convex hull of the points with minX <= x <= maxX and minY <= y <= maxY
+	Polygon query( int minX, int minY, int maxX, int maxY );
+	int getSize();
+
+private:
+	struct Node
+	{
+		//Range of points [first, last) under the node
+		size_t first;
+		size_t last;
+		//Bounding box of those points
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	void build( int node, size_t first, size_t last, int threadLevels );
+	bool isLeaf( int node );
+
+	std::vector<Point> points;
+	std::vector<Node> nodes;
+	//Hull points of each node, sorted with wayToSort
+	std::vector<std::vector<Point>> hulls;
+};
+
+//Time HullIndex queries against filtering and dcHull on nPoints random points
+void benchmarkHullIndex( size_t nPoints, size_t nQueries );
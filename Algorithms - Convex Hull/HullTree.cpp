@@ -0,0 +1,255 @@
+#include "HullTree.h"
+#include "ConvexHull.h"
+
+#include <algorithm>
+#include <utility>
+
+//Sign of a * b + c * d, worked out with 128 bit products so it can't overflow
+static int signOfSum( long long a, long long b, long long c, long long d )
+{
+	unsigned long long hi = 0;
+	unsigned long long lo = 0;
+	addProduct( a, b, hi, lo );
+	addProduct( c, d, hi, lo );
+	return sign128( hi, lo );
+}
+
+//Whether the lines through a1 b1 and a2 b2 cross at or before split in sorted order
+static bool crossBefore( Point a1, Point b1, Point a2, Point b2, Point split )
+{
+	long long const d1x = b1.getX() - a1.getX();
+	long long const d1y = b1.getY() - a1.getY();
+	long long const d2x = b2.getX() - a2.getX();
+	long long const d2y = b2.getY() - a2.getY();
+
+	//The crossing point is a1 + ( num / den ) * d1
+	long long num = ( a2.getX() - (long long) a1.getX() ) * d2y - ( a2.getY() - (long long) a1.getY() ) * d2x;
+	long long den = d1x * d2y - d1y * d2x;
+	if ( den < 0 )
+	{
+		num = -num;
+		den = -den;
+	}
+	//Parallel lines never cross
+	if ( den == 0 )
+	{
+		return true;
+	}
+
+	int const xSign = signOfSum( a1.getX() - (long long) split.getX(), den, num, d1x );
+	if ( xSign != 0 )
+	{
+		return xSign < 0;
+	}
+	return signOfSum( a1.getY() - (long long) split.getY(), den, num, d1y ) <= 0;
+}
+
+HullTree::HullTree( std::vector<Point> sortedPoints )
+{
+	points = std::move( sortedPoints );
+	size_t const nNodes = 4 * std::max( points.size(), (size_t) 1 );
+	nodes.assign( nNodes, Node{ 0, 0, 0, 0, -1, -1, Point(), Point() } );
+	alive.assign( points.size(), true );
+
+	if ( !points.empty() )
+	{
+		build( 1, 0, points.size() );
+	}
+}
+
+HullTree::HullTree()
+{
+}
+
+HullTree::~HullTree()
+{
+}
+
+int HullTree::getSize()
+{
+	return points.empty() ? 0 : nodes.at( 1 ).count;
+}
+
+std::vector<int> HullTree::upperHull()
+{
+	std::vector<int> hull;
+	if ( getSize() > 0 )
+	{
+		report( 1, 0, points.size() - 1, hull );
+	}
+	return hull;
+}
+
+void HullTree::remove( std::vector<int>& positions )
+{
+	if ( !positions.empty() )
+	{
+		removeRange( 1, positions.data(), positions.data() + positions.size() );
+	}
+}
+
+void HullTree::build( int node, int lo, int hi )
+{
+	nodes.at( node ).lo = lo;
+	nodes.at( node ).hi = hi;
+	nodes.at( node ).carrier = node;
+	if ( hi - lo == 1 )
+	{
+		nodes.at( node ).count = 1;
+		nodes.at( node ).leftEnd = points.at( lo );
+		return;
+	}
+
+	int const mid = ( lo + hi ) / 2;
+	build( 2 * node, lo, mid );
+	build( 2 * node + 1, mid, hi );
+	update( node );
+}
+
+void HullTree::removeRange( int node, const int* first, const int* last )
+{
+	if ( nodes.at( node ).hi - nodes.at( node ).lo == 1 )
+	{
+		nodes.at( node ).count = 0;
+		alive.at( nodes.at( node ).lo ) = false;
+		return;
+	}
+
+	//Send each position to the half it lies in, then repair this node's bridge
+	const int* split = std::lower_bound( first, last, nodes.at( 2 * node + 1 ).lo );
+	if ( first != split )
+	{
+		removeRange( 2 * node, first, split );
+	}
+	if ( split != last )
+	{
+		removeRange( 2 * node + 1, split, last );
+	}
+	update( node );
+}
+
+void HullTree::update( int node )
+{
+	Node const& left = nodes.at( 2 * node );
+	Node const& right = nodes.at( 2 * node + 1 );
+	nodes.at( node ).count = left.count + right.count;
+	if ( left.count > 0 && right.count > 0 )
+	{
+		//Removing points can only lower the hulls, so a bridge whose ends are both left still holds
+		bool const hadBridge = nodes.at( node ).carrier == node && nodes.at( node ).bridgeLeft >= 0;
+		if ( !hadBridge || !alive.at( nodes.at( node ).bridgeLeft ) || !alive.at( nodes.at( node ).bridgeRight ) )
+		{
+			findBridge( node );
+		}
+		nodes.at( node ).carrier = node;
+	}
+	else
+	{
+		nodes.at( node ).carrier = left.count > 0 ? left.carrier : right.carrier;
+	}
+}
+
+//Walk down both halves at once, each step ruling out one side of a child's bridge. Where points are
+//collinear with the bridge it ends on the outermost ones, so hulls never keep collinear points
+void HullTree::findBridge( int node )
+{
+	//Last point in the left half. Any line between it and the right half separates the two
+	Point const split = points.at( nodes.at( 2 * node ).hi - 1 );
+
+	int u = 2 * node;
+	int w = 2 * node + 1;
+	while ( true )
+	{
+		Node const& left = nodes.at( nodes.at( u ).carrier );
+		Node const& right = nodes.at( nodes.at( w ).carrier );
+		u = left.carrier;
+		w = right.carrier;
+		bool const uLeaf = left.hi - left.lo == 1;
+		bool const wLeaf = right.hi - right.lo == 1;
+
+		if ( uLeaf && wLeaf )
+		{
+			nodes.at( node ).bridgeLeft = left.lo;
+			nodes.at( node ).bridgeRight = right.lo;
+			nodes.at( node ).leftEnd = left.leftEnd;
+			nodes.at( node ).rightEnd = right.leftEnd;
+			return;
+		}
+
+		if ( uLeaf )
+		{
+			//Tangent from a point to the right hull
+			Point const& p = left.leftEnd;
+			Point const& a2 = right.leftEnd;
+			Point const& b2 = right.rightEnd;
+			w = turn( p, a2, b2 ) >= 0 ? 2 * w + 1 : 2 * w;
+		}
+		else if ( wLeaf )
+		{
+			//Tangent from a point to the left hull
+			Point const& q = right.leftEnd;
+			Point const& a1 = left.leftEnd;
+			Point const& b1 = left.rightEnd;
+			u = turn( b1, q, a1 ) >= 0 ? 2 * u : 2 * u + 1;
+		}
+		else
+		{
+			Point const& a1 = left.leftEnd;
+			Point const& b1 = left.rightEnd;
+			Point const& a2 = right.leftEnd;
+			Point const& b2 = right.rightEnd;
+
+			//Part of the right hull on or above the left bridge: the tangent on the left is at or before a1
+			bool const goLeftU = turn( a1, b1, a2 ) >= 0 || turn( a1, b1, b2 ) >= 0;
+			//Part of the left hull on or above the right bridge: the tangent on the right is at or after b2
+			bool const goRightW = turn( a2, b2, a1 ) >= 0 || turn( a2, b2, b1 ) >= 0;
+
+			if ( goLeftU || goRightW )
+			{
+				if ( goLeftU )
+				{
+					u = 2 * u;
+				}
+				if ( goRightW )
+				{
+					w = 2 * w + 1;
+				}
+			}
+			//Each bridge is under the other: which side of the split they cross decides
+			else if ( crossBefore( a1, b1, a2, b2, split ) )
+			{
+				u = 2 * u + 1;
+			}
+			else
+			{
+				w = 2 * w;
+			}
+		}
+	}
+}
+
+//Add the hull points under node that lie between positions left and right
+void HullTree::report( int node, int left, int right, std::vector<int>& hull )
+{
+	Node const& carrier = nodes.at( nodes.at( node ).carrier );
+	if ( carrier.hi - carrier.lo == 1 )
+	{
+		if ( carrier.lo >= left && carrier.lo <= right )
+		{
+			hull.push_back( carrier.lo );
+		}
+		return;
+	}
+
+	node = nodes.at( node ).carrier;
+	int const a = carrier.bridgeLeft;
+	int const b = carrier.bridgeRight;
+	if ( left <= a )
+	{
+		report( 2 * node, left, std::min( right, a ), hull );
+	}
+	if ( right >= b )
+	{
+		report( 2 * node + 1, std::max( left, b ), right, hull );
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Point.h"
+
+#include <vector>
+
+//Upper hull of a fixed set of points that points can be removed from (Overmars - van Leeuwen).
+//Each node of a balanced tree over the points stores the bridge joining the upper hulls of its two
+//halves, so removing a point only means finding new bridges on the way back up to the root
+class HullTree
+{
+public:
+	//sortedPoints must be sorted with wayToSort and contain no duplicates
+	HullTree( std::vector<Point> sortedPoints );
+	HullTree();
+	~HullTree();
+
+	//Positions of the points on the upper hull of the points left, from left to right
+	std::vector<int> upperHull();
+	//Remove the points at the given positions (sorted, smallest first)
+	void remove( std::vector<int>& positions );
+	int getSize();
+
+private:
+	void build( int node, int lo, int hi );
+	void removeRange( int node, const int* first, const int* last );
+	void update( int node );
+	void findBridge( int node );
+	void report( int node, int left, int right, std::vector<int>& hull );
+
+	struct Node
+	{
+		//Range of positions [lo, hi) under the node
+		int lo;
+		int hi;
+		//Points left under the node
+		int count;
+		//The node itself when it is a leaf or both halves have points left, otherwise the carrier of
+		//the half that does. Both have the same hull
+		int carrier;
+		//Positions of the bridge's ends, set when both halves have points left
+		int bridgeLeft;
+		int bridgeRight;
+		//Copies of the bridge's ends (or of the leaf's point), so walking down the tree stays in nodes
+		Point leftEnd;
+		Point rightEnd;
+	};
+
+	std::vector<Point> points;
+	std::vector<bool> alive;
+	std::vector<Node> nodes;
+};
@@ -0,0 +1,96 @@
+#include "MelkmanHull.h"
+#include "ConvexHull.h"
+
+#include <deque>
+#include <algorithm>
+#include <vector>
+#include <utility>
+
+Polygon melkmanHull( PointView chain )
+{
+	size_t const n = chain.size();
+	if ( n == 0 )
+	{
+		return Polygon();
+	}
+
+	//Skip past the points on a line with the first one. A simple chain can't double back along
+	//a line, so the last of them is the far end from the first
+	size_t k = 1;
+	while ( k < n && chain[k] == chain[0] )
+	{
+		k++;
+	}
+	size_t third = k + 1;
+	while ( third < n && turn( chain[0], chain[third - 1], chain[third] ) == 0 )
+	{
+		third++;
+	}
+	if ( k == n )
+	{
+		return Polygon( std::vector<Point>( 1, chain[0] ) );
+	}
+	if ( third >= n )
+	{
+		//Everything is on one line: the hull is its two ends
+		std::pair<const Point*, const Point*> ends = std::minmax_element( chain.begin(), chain.end(), wayToSort );
+		return Polygon( std::vector<Point>{ *ends.first, *ends.second } );
+	}
+
+	//The hull so far, with the newest point at both ends and right turns all the way round
+	std::deque<Point> hull;
+	if ( rightTurn( chain[0], chain[third - 1], chain[third] ) )
+	{
+		hull = { chain[third], chain[0], chain[third - 1], chain[third] };
+	}
+	else
+	{
+		hull = { chain[third], chain[third - 1], chain[0], chain[third] };
+	}
+
+	for ( size_t i = third + 1; i < n; i++ )
+	{
+		Point const& p = chain[i];
+
+		//Inside the hull near its newest point, so inside the hull
+		if ( rightTurn( hull.at( hull.size() - 2 ), hull.back(), p ) && rightTurn( p, hull.front(), hull.at( 1 ) ) )
+		{
+			continue;
+		}
+
+		while ( !rightTurn( hull.at( hull.size() - 2 ), hull.back(), p ) )
+		{
+			hull.pop_back();
+		}
+		hull.push_back( p );
+
+		while ( !rightTurn( p, hull.front(), hull.at( 1 ) ) )
+		{
+			hull.pop_front();
+		}
+		hull.push_front( p );
+	}
+
+	//Drop the repeated newest point and start at the leftmost point, as convexHull does
+	hull.pop_back();
+	std::deque<Point>::iterator leftmost = std::min_element( hull.begin(), hull.end(), wayToSort );
+	std::rotate( hull.begin(), leftmost, hull.end() );
+
+	//A point that landed on an edge is never popped, as nothing comes after it to pop it. One more
+	//pass of right turns from the leftmost point (always a corner) takes those out
+	std::vector<Point> hullPoints;
+	hullPoints.reserve( hull.size() );
+	for ( size_t i = 0; i < hull.size(); i++ )
+	{
+		while ( hullPoints.size() >= 2 && !rightTurn( hullPoints.at( hullPoints.size() - 2 ), hullPoints.back(), hull.at( i ) ) )
+		{
+			hullPoints.pop_back();
+		}
+		hullPoints.push_back( hull.at( i ) );
+	}
+	while ( hullPoints.size() >= 3 && !rightTurn( hullPoints.at( hullPoints.size() - 2 ), hullPoints.back(), hullPoints.front() ) )
+	{
+		hullPoints.pop_back();
+	}
+	return Polygon( std::move( hullPoints ) );
+}
@@ -0,0 +1,12 @@
+#pragma once
+#include "Polygon.h"
+#include "PointView.h"
+
+//===========================================//
+//===============MELKMAN HULL================//
+//Hull of a simple chain (the vertices of a simple polygon in order, either way round) in one
+//O(n) pass with a deque, no sort. Gives the same polygon as convexHull: right turns starting at
+//the leftmost point. Points that aren't a simple chain give a wrong hull
+Polygon melkmanHull( PointView chain );
+//===============MELKMAN HULL================//
+//===========================================//
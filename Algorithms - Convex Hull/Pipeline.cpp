@@ -0,0 +1,147 @@
+#include "Pipeline.h"
+#include "ConvexHull.h"
+
+#include <algorithm>
+
+Pipeline::Pipeline( size_t queueCapacity )
+	: ingestQueue( queueCapacity ), sortedQueue( queueCapacity ), hulledQueue( queueCapacity )
+{
+	for ( int i = 0; i < STAGE_COUNT; i++ )
+	{
+		stats[i] = StageStats{ 0, 0, 0.0, 0.0 };
+	}
+	totalLatencyMs = 0.0;
+	nRendered = 0;
+
+	sortThread = std::thread( &Pipeline::sortStage, this );
+	hullThread = std::thread( &Pipeline::hullStage, this );
+}
+
+Pipeline::~Pipeline()
+{
+	//Unblock every stage, then wait for the worker threads to exit
+	ingestQueue.close();
+	sortedQueue.close();
+	hulledQueue.close();
+	sortThread.join();
+	hullThread.join();
+}
+
+bool Pipeline::ingest( std::vector<Point> points )
+{
+	auto start = std::chrono::steady_clock::now();
+
+	HullBatch batch;
+	batch.points = std::move( points );
+	batch.ingested = start;
+	//Recorded before the push, so time spent waiting on a slow sort stage isn't counted as ingest time
+	record( STAGE_INGEST, start );
+
+	return ingestQueue.push( std::move( batch ) );
+}
+
+void Pipeline::finish()
+{
+	//Stages close the queue after them once they have drained this one
+	ingestQueue.close();
+}
+
+bool Pipeline::nextHull( HullBatch& batch )
+{
+	//The previous batch has been rendered by the time the next one is asked for
+	if ( nRendered > 0 )
+	{
+		record( STAGE_RENDER, renderStart );
+	}
+
+	if ( !hulledQueue.pop( batch ) )
+	{
+		return false;
+	}
+
+	renderStart = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock( statsMutex );
+	totalLatencyMs += std::chrono::duration<double, std::milli>( renderStart - batch.ingested ).count();
+	nRendered++;
+	return true;
+}
+
+void Pipeline::sortStage()
+{
+	HullBatch batch;
+	while ( ingestQueue.pop( batch ) )
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::sort( batch.points.begin(), batch.points.end(), wayToSort );
+		record( STAGE_SORT, start );
+
+		if ( !sortedQueue.push( std::move( batch ) ) )
+		{
+			break;
+		}
+	}
+	sortedQueue.close();
+}
+
+void Pipeline::hullStage()
+{
+	HullBatch batch;
+	while ( sortedQueue.pop( batch ) )
+	{
+		auto start = std::chrono::steady_clock::now();
+		batch.hull = dcHull( batch.points, 0, batch.points.size() );
+		record( STAGE_HULL, start );
+
+		if ( !hulledQueue.push( std::move( batch ) ) )
+		{
+			break;
+		}
+	}
+	hulledQueue.close();
+}
+
+//Add the time since start to a stage's stats
+void Pipeline::record( PipelineStage stage, std::chrono::steady_clock::time_point start )
+{
+	double const elapsed = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+	std::lock_guard<std::mutex> lock( statsMutex );
+	StageStats& s = stats[stage];
+	s.averageMs = ( s.averageMs * s.batches + elapsed ) / ( s.batches + 1 );
+	s.maxMs = std::max( s.maxMs, elapsed );
+	s.batches++;
+}
+
+StageStats Pipeline::getStats( PipelineStage stage )
+{
+	StageStats s;
+	{
+		std::lock_guard<std::mutex> lock( statsMutex );
+		s = stats[stage];
+	}
+
+	//Depth of the queue feeding this stage (nothing feeds ingest)
+	if ( stage == STAGE_SORT )
+	{
+		s.queueDepth = ingestQueue.size();
+	}
+	else if ( stage == STAGE_HULL )
+	{
+		s.queueDepth = sortedQueue.size();
+	}
+	else if ( stage == STAGE_RENDER )
+	{
+		s.queueDepth = hulledQueue.size();
+	}
+	return s;
+}
+
+double Pipeline::getAverageLatency()
+{
+	std::lock_guard<std::mutex> lock( statsMutex );
+	if ( nRendered == 0 )
+	{
+		return 0.0;
+	}
+	return totalLatencyMs / nRendered;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+#include "BoundedQueue.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+
+enum PipelineStage
+{
+	STAGE_INGEST,
+	STAGE_SORT,
+	STAGE_HULL,
+	STAGE_RENDER,
+	STAGE_COUNT
+};
+
+//Timings for one pipeline stage
+struct StageStats
+{
+	//Batches waiting in front of this stage
+	size_t queueDepth;
+	//Batches through this stage
+	size_t batches;
+	double averageMs;
+	double maxMs;
+};
+
+//One batch of points on its way through the pipeline
+struct HullBatch
+{
+	std::vector<Point> points;
+	Polygon hull;
+	std::chrono::steady_clock::time_point ingested;
+};
+
+//Runs ingest -> sort -> hull -> render with a bounded queue between each stage, so batch k + 1
+//can be sorted while batch k is hulled and batch k - 1 is drawn. Sort and hull run on their own
+//threads, ingest and render run on whichever thread calls ingest() and nextHull()
+class Pipeline
+{
+public:
+	Pipeline( size_t queueCapacity );
+	~Pipeline();
+
+	//Ingest stage: queue a batch of points, waiting while the sort stage is behind. Returns false,
+	//dropping the batch, once finish() has been called
+	bool ingest( std::vector<Point> points );
+	//No more batches will be ingested
+	void finish();
+	//Render stage: take the next hulled batch. Returns false once every batch has been rendered
+	bool nextHull( HullBatch& batch );
+
+	StageStats getStats( PipelineStage stage );
+	//Average time from ingest() to nextHull() handing the batch back
+	double getAverageLatency();
+
+private:
+	void sortStage();
+	void hullStage();
+	void record( PipelineStage stage, std::chrono::steady_clock::time_point start );
+
+	BoundedQueue<HullBatch> ingestQueue;
+	BoundedQueue<HullBatch> sortedQueue;
+	BoundedQueue<HullBatch> hulledQueue;
+
+	std::thread sortThread;
+	std::thread hullThread;
+
+	std::mutex statsMutex;
+	StageStats stats[STAGE_COUNT];
+	double totalLatencyMs;
+	size_t nRendered;
+	//When nextHull() last handed a batch to the renderer
+	std::chrono::steady_clock::time_point renderStart;
+};
@@ -17,12 +17,12 @@ Point::~Point()
 {
 }
 
-int Point::getX()
+int Point::getX() const
 {
 	return xPos;
 }
 
-int Point::getY()
+int Point::getY() const
 {
 	return yPos;
 }
@@ -38,7 +38,7 @@ void Point::setY( int y )
 }
 
 //Point comparison
-bool Point::operator == ( Point& toCompare )
+bool Point::operator == ( const Point& toCompare ) const
 {
 	if ( getX() == toCompare.getX() )
 	{
@@ -50,13 +50,13 @@ bool Point::operator == ( Point& toCompare )
 	}
 }
 
-void Point::print()
+void Point::print() const
 {
 	std::cout << "(" << getX() << ", " << getY() << ")" << std::endl;
 }
 
 //Draw this point as a rectangle
-void Point::drawPoint( SDL_Renderer * renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a )
+void Point::drawPoint( SDL_Renderer * renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a ) const
 {
 	SDL_SetRenderDrawColor( renderer, r, g, b, a );
 	SDL_Rect rect{ getX() - 1, getY() - 1, 3, 3 };
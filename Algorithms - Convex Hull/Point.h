@@ -8,15 +8,15 @@ public:
 	Point();
 	~Point();
 
-	int getX();
-	int getY();
+	int getX() const;
+	int getY() const;
 	void setX( int x );
 	void setY( int y );
 
-	bool operator == ( Point& toCompare );
-	void print();
+	bool operator == ( const Point& toCompare ) const;
+	void print() const;
 
-	void drawPoint( SDL_Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a );
+	void drawPoint( SDL_Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a ) const;
 
 private:
 	int xPos;
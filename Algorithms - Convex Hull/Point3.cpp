@@ -0,0 +1,61 @@
+#include "Point3.h"
+#include <iostream>
+
+Point3::Point3( int x, int y, int z )
+{
+	xPos = x;
+	yPos = y;
+	zPos = z;
+}
+
+Point3::Point3()
+{
+	xPos = 0;
+	yPos = 0;
+	zPos = 0;
+}
+
+Point3::~Point3()
+{
+}
+
+int Point3::getX() const
+{
+	return xPos;
+}
+
+int Point3::getY() const
+{
+	return yPos;
+}
+
+int Point3::getZ() const
+{
+	return zPos;
+}
+
+void Point3::setX( int x )
+{
+	xPos = x;
+}
+
+void Point3::setY( int y )
+{
+	yPos = y;
+}
+
+void Point3::setZ( int z )
+{
+	zPos = z;
+}
+
+//Point comparison
+bool Point3::operator == ( const Point3& toCompare ) const
+{
+	return getX() == toCompare.getX() && getY() == toCompare.getY() && getZ() == toCompare.getZ();
+}
+
+void Point3::print() const
+{
+	std::cout << "(" << getX() << ", " << getY() << ", " << getZ() << ")" << std::endl;
+}
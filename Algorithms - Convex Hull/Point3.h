@@ -0,0 +1,26 @@
+#pragma once
+
+//A point in space, for 3D scan data. Coordinates are kept within +-2^30 so the exact predicates in
+//Hull3 can't overflow
+class Point3
+{
+public:
+	Point3( int x, int y, int z );
+	Point3();
+	~Point3();
+
+	int getX() const;
+	int getY() const;
+	int getZ() const;
+	void setX( int x );
+	void setY( int y );
+	void setZ( int z );
+
+	bool operator == ( const Point3& toCompare ) const;
+	void print() const;
+
+private:
+	int xPos;
+	int yPos;
+	int zPos;
+};
@@ -0,0 +1,48 @@
+#include "PointView.h"
+#include <stdexcept>
+
+PointView::PointView( const Point* first, size_t count )
+{
+	firstPoint = first;
+	nPoints = count;
+}
+
+PointView::PointView()
+{
+	firstPoint = nullptr;
+	nPoints = 0;
+}
+
+const Point* PointView::begin() const
+{
+	return firstPoint;
+}
+
+const Point* PointView::end() const
+{
+	return firstPoint + nPoints;
+}
+
+size_t PointView::size() const
+{
+	return nPoints;
+}
+
+bool PointView::empty() const
+{
+	return nPoints == 0;
+}
+
+const Point& PointView::operator [] ( size_t index ) const
+{
+	return firstPoint[index];
+}
+
+const Point& PointView::at( size_t index ) const
+{
+	if ( index >= nPoints )
+	{
+		throw std::out_of_range( "PointView::at" );
+	}
+	return firstPoint[index];
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "Point.h"
+
+#include <cstddef>
+
+//Read-only view of a run of points owned by something else (no copy is made)
+class PointView
+{
+public:
+	PointView( const Point* first, size_t count );
+	PointView();
+
+	const Point* begin() const;
+	const Point* end() const;
+	size_t size() const;
+	bool empty() const;
+
+	const Point& operator [] ( size_t index ) const;
+	//Bounds checked access, throws std::out_of_range like std::vector::at
+	const Point& at( size_t index ) const;
+
+private:
+	const Point* firstPoint;
+	size_t nPoints;
+};
@@ -1,79 +1,120 @@
 #include "Polygon.h"
+#include "ConvexHull.h"
+#include "MelkmanHull.h"
+#include <algorithm>
+#include <utility>
 
 Polygon::Polygon( std::vector<int> xP, std::vector<int> yP )
 {
 	rightmostIndex = 0;
 	leftmostIndex = 0;
-	nPoints = 0;
-	xPoints = xP;
-	yPoints = yP;
-	fillPoints();
+	simple = false;
+	fillPoints( xP, yP );
 }
 
 Polygon::Polygon( std::vector<Point> points )
 {
 	rightmostIndex = 0;
 	leftmostIndex = 0;
-	for ( size_t i = 0; i < points.size(); i++ )
+	simple = false;
+	allPoints = std::move( points );
+	for ( size_t i = 1; i < allPoints.size(); i++ )
 	{
-		allPoints.push_back( points.at( i ) );
-		//Update leftmost and rightmost point if necessary
-		if ( points.at( i ).getX() > allPoints.at( rightmostIndex ).getX() )
-		{
-			rightmostIndex = allPoints.size() - 1;
-		}
-		if ( points.at( i ).getX() < allPoints.at( leftmostIndex ).getX() )
-		{
-			leftmostIndex = allPoints.size() - 1;
-		}
+		updateExtremes( i );
 	}
-	nPoints = allPoints.size();
 }
 
 Polygon::Polygon()
 {
 	rightmostIndex = 0;
 	leftmostIndex = 0;
-	nPoints = 0;
+	simple = false;
 }
 
 Polygon::~Polygon()
 {
 }
 
-std::vector<Point> Polygon::getPoints()
+std::vector<Point> Polygon::getPoints() const
 {
 	return allPoints;
 }
 
-int Polygon::getRightmostIndex()
+std::vector<Point> Polygon::takePoints()
+{
+	std::vector<Point> points = std::move( allPoints );
+	allPoints.clear();
+	rightmostIndex = 0;
+	leftmostIndex = 0;
+	simple = false;
+	return points;
+}
+
+PointView Polygon::getView() const
+{
+	return PointView( allPoints.data(), allPoints.size() );
+}
+
+const Point& Polygon::getPoint( int index ) const
+{
+	return allPoints.at( index );
+}
+
+int Polygon::getSize() const
+{
+	return (int) allPoints.size();
+}
+
+int Polygon::getRightmostIndex() const
 {
 	return rightmostIndex;
 }
 
-int Polygon::getLeftmostIndex()
+int Polygon::getLeftmostIndex() const
 {
 	return leftmostIndex;
 }
 
-void Polygon::drawPolygon( SDL_Renderer * renderer )
+void Polygon::setSimple( bool isSimple )
 {
-	for ( int i = 1; i < nPoints; i++ )
+	simple = isSimple;
+}
+
+bool Polygon::getSimple() const
+{
+	return simple;
+}
+
+Polygon Polygon::hull() const
+{
+	if ( simple )
+	{
+		return melkmanHull( getView() );
+	}
+
+	std::vector<Point> sortedPoints = allPoints;
+	std::sort( sortedPoints.begin(), sortedPoints.end(), wayToSort );
+	return dcHull( sortedPoints );
+}
+
+void Polygon::drawPolygon( SDL_Renderer * renderer ) const
+{
+	for ( size_t i = 1; i < allPoints.size(); i++ )
 	{
 		//Draw each line
 		SDL_RenderDrawLine( renderer, allPoints.at( i - 1 ).getX(), allPoints.at( i - 1 ).getY(), allPoints.at( i ).getX(), allPoints.at( i ).getY() );
 	}
 	//Final line
-	if ( nPoints > 1 )
+	if ( allPoints.size() > 1 )
 	{
-		SDL_RenderDrawLine( renderer, allPoints.at( nPoints - 1 ).getX(), allPoints.at( nPoints - 1 ).getY(), allPoints.at( 0 ).getX(), allPoints.at( 0 ).getY() );
+		SDL_RenderDrawLine( renderer, allPoints.back().getX(), allPoints.back().getY(), allPoints.at( 0 ).getX(), allPoints.at( 0 ).getY() );
 	}
 }
 
 //Translate the polygon by (dx, dy)
 void Polygon::translate( int dx, int dy )
 {
-	for ( int i = 0; i < nPoints; i++ )
+	for ( size_t i = 0; i < allPoints.size(); i++ )
 	{
 		allPoints.at( i ).setX( allPoints.at( i ).getX() + dx );
 		allPoints.at( i ).setY( allPoints.at( i ).getY() + dy );
@@ -81,41 +122,43 @@ void Polygon::translate( int dx, int dy )
 }
 
 //Fill allPoints vector with each point in the polygon
-void Polygon::fillPoints()
+void Polygon::fillPoints( std::vector<int>& xP, std::vector<int>& yP )
 {
-	for ( size_t i = 0; i < xPoints.size(); i++ )
+	allPoints.reserve( xP.size() );
+	for ( size_t i = 0; i < xP.size(); i++ )
 	{
-		allPoints.push_back( Point( xPoints.at( i ), yPoints.at( i ) ) );
-		//Update leftmost and rightmost point if necessary
-		if ( xPoints.at( i ) > allPoints.at( rightmostIndex ).getX() )
-		{
-			rightmostIndex = allPoints.size() - 1;
-		}
-		if ( xPoints.at( i ) < allPoints.at( leftmostIndex ).getX() )
-		{
-			leftmostIndex = allPoints.size() - 1;
-		}
+		allPoints.push_back( Point( xP.at( i ), yP.at( i ) ) );
+		updateExtremes( allPoints.size() - 1 );
 	}
-	nPoints = allPoints.size();
 }
 
 //Add a specific point to the polygon
 void Polygon::addPoint( Point p )
 {
 	allPoints.push_back( p );
-	//Update leftmost and rightmost point if necessary
-	if ( p.getX() > allPoints.at( rightmostIndex ).getX() )
+	updateExtremes( allPoints.size() - 1 );
+	//The new point could be anywhere, so the polygon may not be simple any more
+	simple = false;
+}
+
+//Update leftmost and rightmost point if the point at index is further out (ties broken by y)
+void Polygon::updateExtremes( int index )
+{
+	const Point& p = allPoints.at( index );
+	const Point& rightmost = allPoints.at( rightmostIndex );
+	const Point& leftmost = allPoints.at( leftmostIndex );
+
+	if ( p.getX() > rightmost.getX() || ( p.getX() == rightmost.getX() && p.getY() > rightmost.getY() ) )
 	{
-		rightmostIndex = allPoints.size() - 1;
+		rightmostIndex = index;
 	}
-	if ( p.getX() < allPoints.at( leftmostIndex ).getX() )
+	if ( p.getX() < leftmost.getX() || ( p.getX() == leftmost.getX() && p.getY() < leftmost.getY() ) )
 	{
-		leftmostIndex = allPoints.size() - 1;
+		leftmostIndex = index;
 	}
-	nPoints++;
 }
 
-void Polygon::toString()
+void Polygon::toString() const
 {
 	for ( size_t i = 0; i < allPoints.size(); i++ )
 		allPoints.at( i ).print();
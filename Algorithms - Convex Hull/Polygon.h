@@ -1,32 +1,49 @@
 #pragma once
 #include "Point.h"
+#include "PointView.h"
 #include <vector>
 
 class Polygon
 {
 public:
 	Polygon( std::vector<int> xP, std::vector<int> yP );
+	//Takes ownership of points when passed an rvalue (no copy)
 	Polygon( std::vector<Point> points);
 	Polygon();
 	~Polygon();
 
+	Polygon( const Polygon& other ) = default;
+	Polygon( Polygon&& other ) = default;
+	Polygon& operator = ( const Polygon& other ) = default;
+	Polygon& operator = ( Polygon&& other ) = default;
+
 	void translate( int dx, int dy );
-	std::vector<Point> getPoints();
-	int getRightmostIndex();
-	int getLeftmostIndex();
+	std::vector<Point> getPoints() const;
+	//Hand the points over without copying them, leaving the polygon empty
+	std::vector<Point> takePoints();
+	//Read-only view of the points, valid until the polygon is changed or destroyed
+	PointView getView() const;
+	const Point& getPoint( int index ) const;
+	int getSize() const;
+	int getRightmostIndex() const;
+	int getLeftmostIndex() const;
+	//Whether the points are known to be the vertices of a simple polygon, in order. Adding a point clears it
+	void setSimple( bool isSimple );
+	bool getSimple() const;
+	//Convex hull of the points: one linear pass over a simple polygon, otherwise sort and dcHull
+	Polygon hull() const;
 
-	void drawPolygon( SDL_Renderer* renderer );
+	void drawPolygon( SDL_Renderer* renderer ) const;
 	void addPoint( Point p );
-	void toString();
+	void toString() const;
 
 private:
-	void fillPoints();
+	void fillPoints( std::vector<int>& xP, std::vector<int>& yP );
+	void updateExtremes( int index );
 
-	std::vector<int> xPoints;
-	std::vector<int> yPoints;
 	std::vector<Point> allPoints;
-	int nPoints;
 	int rightmostIndex;
 	int leftmostIndex;
+	bool simple;
 };
 
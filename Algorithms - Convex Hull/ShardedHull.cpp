@@ -0,0 +1,536 @@
+#include "ShardedHull.h"
+#include "ConvexHull.h"
+
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <climits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <sched.h>
+extern char** environ;
+#endif
+
+//Command line flag that starts the program as a worker: flag, segment name, shard
+static char const* const workerFlag = "--hull-shard";
+static unsigned const shardMagic = 0x48554C4C;
+//Most shards processShardedHull will split into
+static size_t const maxProcessShards = 256;
+
+//Start of the shared segment. After it come the points as x, y pairs, then the same amount of room
+//for the results: each worker writes its hull at the start of its own slab's share
+struct ShardHeader
+{
+	unsigned magic;
+	unsigned nShards;
+	unsigned long long nPoints;
+	unsigned long long bounds[maxProcessShards + 1];
+	//Set by each worker when it has written its hull (ULLONG_MAX until then)
+	unsigned long long hullSizes[maxProcessShards];
+	int nodes[maxProcessShards];
+};
+
+//A named block of memory that other processes on this machine can map
+class SharedSegment
+{
+public:
+	SharedSegment();
+	~SharedSegment();
+
+	bool create( const std::string& segmentName, size_t bytes );
+	bool open( const std::string& segmentName );
+	void* getData();
+
+private:
+	void* memory;
+	size_t size;
+#ifdef _WIN32
+	HANDLE mapping;
+#else
+	std::string name;
+	bool owner;
+#endif
+};
+
+SharedSegment::SharedSegment()
+{
+	memory = nullptr;
+	size = 0;
+#ifdef _WIN32
+	mapping = NULL;
+#else
+	owner = false;
+#endif
+}
+
+SharedSegment::~SharedSegment()
+{
+#ifdef _WIN32
+	if ( memory )
+	{
+		UnmapViewOfFile( memory );
+	}
+	if ( mapping )
+	{
+		CloseHandle( mapping );
+	}
+#else
+	if ( memory )
+	{
+		munmap( memory, size );
+	}
+	if ( owner )
+	{
+		shm_unlink( name.c_str() );
+	}
+#endif
+}
+
+bool SharedSegment::create( const std::string& segmentName, size_t bytes )
+{
+#ifdef _WIN32
+	mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD) ( (unsigned long long) bytes >> 32 ), (DWORD) bytes, segmentName.c_str() );
+	if ( !mapping || GetLastError() == ERROR_ALREADY_EXISTS )
+	{
+		return false;
+	}
+	memory = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes );
+#else
+	int const fd = shm_open( segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+	if ( fd < 0 )
+	{
+		return false;
+	}
+	name = segmentName;
+	owner = true;
+	if ( ftruncate( fd, (off_t) bytes ) != 0 )
+	{
+		close( fd );
+		return false;
+	}
+	void* const mapped = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+	memory = mapped == MAP_FAILED ? nullptr : mapped;
+#endif
+	size = bytes;
+	return memory != nullptr;
+}
+
+bool SharedSegment::open( const std::string& segmentName )
+{
+#ifdef _WIN32
+	mapping = OpenFileMappingA( FILE_MAP_ALL_ACCESS, FALSE, segmentName.c_str() );
+	if ( !mapping )
+	{
+		return false;
+	}
+	memory = MapViewOfFile( mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0 );
+#else
+	int const fd = shm_open( segmentName.c_str(), O_RDWR, 0600 );
+	if ( fd < 0 )
+	{
+		return false;
+	}
+	struct stat info;
+	if ( fstat( fd, &info ) != 0 )
+	{
+		close( fd );
+		return false;
+	}
+	size = info.st_size;
+	void* const mapped = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	close( fd );
+	memory = mapped == MAP_FAILED ? nullptr : mapped;
+#endif
+	return memory != nullptr;
+}
+
+void* SharedSegment::getData()
+{
+	return memory;
+}
+
+int numaNodeCount()
+{
+#ifdef _WIN32
+	ULONG highest = 0;
+	if ( !GetNumaHighestNodeNumber( &highest ) )
+	{
+		return 1;
+	}
+	return (int) highest + 1;
+#else
+	int nodes = 0;
+	while ( std::ifstream( "/sys/devices/system/node/node" + std::to_string( nodes ) + "/cpulist" ) )
+	{
+		nodes++;
+	}
+	return std::max( nodes, 1 );
+#endif
+}
+
+//Keep the calling thread on the processors of one NUMA node, so memory it touches first is put there
+static void pinToNode( int node )
+{
+#ifdef _WIN32
+	GROUP_AFFINITY affinity = {};
+	if ( GetNumaNodeProcessorMaskEx( (USHORT) node, &affinity ) )
+	{
+		SetThreadGroupAffinity( GetCurrentThread(), &affinity, NULL );
+	}
+#elif defined( __linux__ )
+	//The node's processors are listed as ranges, e.g. "0-3,8-11"
+	std::ifstream list( "/sys/devices/system/node/node" + std::to_string( node ) + "/cpulist" );
+	std::string ranges;
+	if ( !std::getline( list, ranges ) )
+	{
+		return;
+	}
+	cpu_set_t cpus;
+	CPU_ZERO( &cpus );
+	size_t start = 0;
+	while ( start < ranges.size() )
+	{
+		size_t end = ranges.find( ',', start );
+		if ( end == std::string::npos )
+		{
+			end = ranges.size();
+		}
+		std::string const range = ranges.substr( start, end - start );
+		size_t const dash = range.find( '-' );
+		int const first = std::atoi( range.c_str() );
+		int const last = dash == std::string::npos ? first : std::atoi( range.c_str() + dash + 1 );
+		for ( int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++ )
+		{
+			CPU_SET( cpu, &cpus );
+		}
+		start = end + 1;
+	}
+	if ( CPU_COUNT( &cpus ) > 0 )
+	{
+		sched_setaffinity( 0, sizeof( cpus ), &cpus );
+	}
+#else
+	( void ) node;
+#endif
+}
+
+//Shard boundaries, pushed forward so no column of points is split between two shards
+static std::vector<size_t> shardBounds( const std::vector<Point>& sortedPoints, size_t nShards )
+{
+	//Shards smaller than this cost more in start-up than they save
+	size_t const minShardSize = 1 << 12;
+	size_t const n = sortedPoints.size();
+
+	std::vector<size_t> bounds;
+	bounds.push_back( 0 );
+	for ( size_t s = 1; s < nShards; s++ )
+	{
+		size_t b = std::max( n * s / nShards, bounds.back() );
+		while ( b > 0 && b < n && sortedPoints.at( b ).getX() == sortedPoints.at( b - 1 ).getX() )
+		{
+			b++;
+		}
+		if ( b - bounds.back() >= minShardSize && n - b >= minShardSize )
+		{
+			bounds.push_back( b );
+		}
+	}
+	bounds.push_back( n );
+	return bounds;
+}
+
+//Shards are ordered by x, so merge them left to right
+static Polygon mergeShards( const std::vector<Polygon>& partialHulls )
+{
+	Polygon hull = partialHulls.at( 0 );
+	for ( size_t s = 1; s < partialHulls.size(); s++ )
+	{
+		hull = bridgeMerge( hull, partialHulls.at( s ) );
+	}
+	return hull;
+}
+
+Polygon shardedHull( std::vector<Point>& sortedPoints, size_t nShards )
+{
+	std::vector<size_t> const bounds = shardBounds( sortedPoints, nShards );
+
+	//Hull each shard on its own thread (the calling thread takes the first shard)
+	size_t const shardCount = bounds.size() - 1;
+	std::vector<Polygon> partialHulls( shardCount );
+	auto hullShard = [&]( size_t s )
+	{
+		partialHulls.at( s ) = dcHull( sortedPoints, bounds.at( s ), bounds.at( s + 1 ) );
+	};
+
+	std::vector<std::thread> workers;
+	for ( size_t s = 1; s < shardCount; s++ )
+	{
+		workers.push_back( std::thread( hullShard, s ) );
+	}
+	hullShard( 0 );
+	for ( size_t s = 0; s < workers.size(); s++ )
+	{
+		workers.at( s ).join();
+	}
+
+	return mergeShards( partialHulls );
+}
+
+//Start this program again as the worker for one shard. Returns false if it couldn't be started
+#ifdef _WIN32
+static bool startWorker( const std::string& segmentName, size_t shard, HANDLE& process )
+{
+	char path[MAX_PATH];
+	DWORD const length = GetModuleFileNameA( NULL, path, MAX_PATH );
+	if ( length == 0 || length == MAX_PATH )
+	{
+		return false;
+	}
+	std::string commandLine = "\"" + std::string( path ) + "\" " + workerFlag + " " + segmentName + " " + std::to_string( shard );
+
+	STARTUPINFOA startup = {};
+	startup.cb = sizeof( startup );
+	PROCESS_INFORMATION info = {};
+	if ( !CreateProcessA( path, &commandLine[0], NULL, NULL, FALSE, 0, NULL, NULL, &startup, &info ) )
+	{
+		return false;
+	}
+	CloseHandle( info.hThread );
+	process = info.hProcess;
+	return true;
+}
+
+//Wait for a worker and whether it succeeded
+static bool finishWorker( HANDLE process )
+{
+	WaitForSingleObject( process, INFINITE );
+	DWORD code = 1;
+	GetExitCodeProcess( process, &code );
+	CloseHandle( process );
+	return code == 0;
+}
+#else
+static bool startWorker( const std::string& segmentName, size_t shard, pid_t& process )
+{
+	std::string program = "/proc/self/exe";
+	std::string flag = workerFlag;
+	std::string segment = segmentName;
+	std::string shardText = std::to_string( shard );
+	char* const arguments[] = { &program[0], &flag[0], &segment[0], &shardText[0], nullptr };
+	return posix_spawn( &process, program.c_str(), nullptr, nullptr, arguments, environ ) == 0;
+}
+
+static bool finishWorker( pid_t process )
+{
+	int status = 0;
+	if ( waitpid( process, &status, 0 ) != process )
+	{
+		return false;
+	}
+	return WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+}
+#endif
+
+Polygon processShardedHull( std::vector<Point>& sortedPoints, size_t nShards, bool& usedProcesses )
+{
+	usedProcesses = false;
+	std::vector<size_t> const bounds = shardBounds( sortedPoints, std::min( nShards, maxProcessShards ) );
+	size_t const shardCount = bounds.size() - 1;
+	size_t const n = sortedPoints.size();
+
+	//A name no other run is using
+	static int runs = 0;
+#ifdef _WIN32
+	std::string const segmentName = "Local\\ConvexHullShards" + std::to_string( GetCurrentProcessId() ) + "_" + std::to_string( runs++ );
+#else
+	std::string const segmentName = "/ConvexHullShards" + std::to_string( getpid() ) + "_" + std::to_string( runs++ );
+#endif
+
+	SharedSegment segment;
+	if ( !segment.create( segmentName, sizeof( ShardHeader ) + 4 * n * sizeof( int ) ) )
+	{
+		return shardedHull( sortedPoints, nShards );
+	}
+	ShardHeader* const header = (ShardHeader*) segment.getData();
+	int* const coordinates = (int*) ( header + 1 );
+	int* const results = coordinates + 2 * n;
+
+	//Neighbouring shards share a node, so each node gets one run of slabs
+	int const nNodes = numaNodeCount();
+	header->magic = shardMagic;
+	header->nShards = (unsigned) shardCount;
+	header->nPoints = n;
+	for ( size_t s = 0; s <= shardCount; s++ )
+	{
+		header->bounds[s] = bounds.at( s );
+	}
+	for ( size_t s = 0; s < shardCount; s++ )
+	{
+		header->hullSizes[s] = ULLONG_MAX;
+		header->nodes[s] = (int) ( s * nNodes / shardCount );
+	}
+
+	//Copy each slab in from a thread on the node that will hull it, so its pages are put there
+	std::vector<std::thread> fillers;
+	for ( size_t s = 0; s < shardCount; s++ )
+	{
+		fillers.push_back( std::thread( [&, s]
+		{
+			pinToNode( header->nodes[s] );
+			for ( size_t i = bounds.at( s ); i < bounds.at( s + 1 ); i++ )
+			{
+				coordinates[2 * i] = sortedPoints[i].getX();
+				coordinates[2 * i + 1] = sortedPoints[i].getY();
+			}
+		} ) );
+	}
+	for ( size_t s = 0; s < fillers.size(); s++ )
+	{
+		fillers.at( s ).join();
+	}
+
+#ifdef _WIN32
+	std::vector<HANDLE> processes;
+	HANDLE process;
+#else
+	std::vector<pid_t> processes;
+	pid_t process;
+#endif
+	bool started = true;
+	for ( size_t s = 0; s < shardCount && started; s++ )
+	{
+		started = startWorker( segmentName, s, process );
+		if ( started )
+		{
+			processes.push_back( process );
+		}
+	}
+	bool succeeded = started;
+	for ( size_t s = 0; s < processes.size(); s++ )
+	{
+		succeeded = finishWorker( processes.at( s ) ) && succeeded;
+	}
+	for ( size_t s = 0; s < shardCount && succeeded; s++ )
+	{
+		succeeded = header->hullSizes[s] <= bounds.at( s + 1 ) - bounds.at( s );
+	}
+	if ( !succeeded )
+	{
+		return shardedHull( sortedPoints, nShards );
+	}
+
+	std::vector<Polygon> partialHulls( shardCount );
+	for ( size_t s = 0; s < shardCount; s++ )
+	{
+		std::vector<Point> hull;
+		hull.reserve( (size_t) header->hullSizes[s] );
+		int const* const slab = results + 2 * bounds.at( s );
+		for ( size_t i = 0; i < header->hullSizes[s]; i++ )
+		{
+			hull.push_back( Point( slab[2 * i], slab[2 * i + 1] ) );
+		}
+		partialHulls.at( s ) = Polygon( std::move( hull ) );
+	}
+
+	usedProcesses = true;
+	return mergeShards( partialHulls );
+}
+
+bool isShardWorker( int argc, char* args[] )
+{
+	return argc == 4 && std::string( args[1] ) == workerFlag;
+}
+
+int runShardWorker( int argc, char* args[] )
+{
+	SharedSegment segment;
+	if ( !isShardWorker( argc, args ) || !segment.open( args[2] ) )
+	{
+		return 1;
+	}
+	ShardHeader* const header = (ShardHeader*) segment.getData();
+	size_t const shard = (size_t) std::strtoul( args[3], nullptr, 10 );
+	if ( header->magic != shardMagic || shard >= header->nShards )
+	{
+		return 1;
+	}
+	pinToNode( header->nodes[shard] );
+
+	size_t const first = (size_t) header->bounds[shard];
+	size_t const last = (size_t) header->bounds[shard + 1];
+	int const* const coordinates = (int*) ( header + 1 );
+	int* const results = (int*) ( header + 1 ) + 2 * header->nPoints;
+
+	std::vector<Point> slab;
+	slab.reserve( last - first );
+	for ( size_t i = first; i < last; i++ )
+	{
+		slab.push_back( Point( coordinates[2 * i], coordinates[2 * i + 1] ) );
+	}
+	Polygon const hull = dcHull( slab, 0, slab.size() );
+
+	PointView const points = hull.getView();
+	for ( size_t i = 0; i < points.size(); i++ )
+	{
+		results[2 * ( first + i )] = points[i].getX();
+		results[2 * ( first + i ) + 1] = points[i].getY();
+	}
+	header->hullSizes[shard] = points.size();
+	return 0;
+}
+
+void benchmarkShardedHull( size_t nPoints, size_t maxShards )
+{
+	//Random points spread wide enough in x that few share a column
+	std::mt19937 rng( 1 );
+	std::uniform_int_distribution<int> xDist( 0, (int) std::min( nPoints * 8, (size_t) 1 << 30 ) );
+	std::uniform_int_distribution<int> yDist( 0, 1 << 15 );
+
+	std::vector<Point> sortedPoints;
+	sortedPoints.reserve( nPoints );
+	for ( size_t i = 0; i < nPoints; i++ )
+	{
+		sortedPoints.push_back( Point( xDist( rng ), yDist( rng ) ) );
+	}
+	std::sort( sortedPoints.begin(), sortedPoints.end(), wayToSort );
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<Point> const expected = dcHull( sortedPoints ).getPoints();
+	double const baseline = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	std::cout << "dcHull: " << nPoints << " points, " << expected.size() << " on hull, " << baseline << " ms" << std::endl;
+
+	for ( size_t nShards = 1; nShards <= maxShards; nShards *= 2 )
+	{
+		start = std::chrono::steady_clock::now();
+		std::vector<Point> const hull = shardedHull( sortedPoints, nShards ).getPoints();
+		double const elapsed = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+		std::cout << "shardedHull: " << nShards << " shards, " << hull.size() << " on hull, " << elapsed << " ms (x" << baseline / elapsed << ")" << ( hull == expected ? "" : " (MISMATCH)" ) << std::endl;
+	}
+
+	//Processes: shards are spread over the NUMA nodes, so more shards reach more sockets
+	int const nNodes = numaNodeCount();
+	for ( size_t nShards = 1; nShards <= maxShards; nShards *= 2 )
+	{
+		start = std::chrono::steady_clock::now();
+		bool usedProcesses;
+		std::vector<Point> const hull = processShardedHull( sortedPoints, nShards, usedProcesses ).getPoints();
+		double const elapsed = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+		std::cout << "processShardedHull: " << nShards << " shards over " << std::min( (size_t) nNodes, nShards ) << " of " << nNodes << " NUMA nodes, " << hull.size() << " on hull, " << elapsed << " ms (x" << baseline / elapsed << ")" << ( usedProcesses ? "" : " (fell back to threads)" ) << ( hull == expected ? "" : " (MISMATCH)" ) << std::endl;
+	}
+}
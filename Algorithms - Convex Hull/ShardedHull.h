@@ -0,0 +1,24 @@
+#pragma once
+#include "Polygon.h"
+#include "Point.h"
+
+#include <vector>
+
+//===========================================//
+//===============SHARDED HULL================//
+//Split sortedPoints into nShards x-slabs, hull each slab on its own thread and merge the partial hulls
+Polygon shardedHull( std::vector<Point>& sortedPoints, size_t nShards );
+//As shardedHull, but each slab is hulled by a worker process pinned to a NUMA node, reading its slab
+//from a shared memory buffer filled from that node. If the buffer or the workers can't be set up it
+//falls back to shardedHull, and usedProcesses says which ran
+Polygon processShardedHull( std::vector<Point>& sortedPoints, size_t nShards, bool& usedProcesses );
+//NUMA nodes on this machine (1 if it has none or they can't be read)
+int numaNodeCount();
+//Whether the program was started as a processShardedHull worker. main checks this first and, if so,
+//returns runShardWorker() without opening a window
+bool isShardWorker( int argc, char* args[] );
+int runShardWorker( int argc, char* args[] );
+//Time dcHull against shardedHull and processShardedHull with 1 to maxShards shards on nPoints random points
+void benchmarkShardedHull( size_t nPoints, size_t maxShards );
+//===============SHARDED HULL================//
+//===========================================//
@@ -1,39 +1,19 @@
 #include "Polygon.h"
 #include "Point.h"
+#include "ConvexHull.h"
+#include "ShardedHull.h"
+#include "Pipeline.h"
+#include "HullIndex.h"
+#include "HullCodec.h"
+#include "Hull3.h"
+#include "Collision.h"
 
 #include <SDL.h>
 #include <iostream>
 #include <vector>
 #include <algorithm>
-
-
-//===========================================//
-//================CONVEX HULL================//
-//sort by x coordinate then y coordinate
-bool wayToSort( Point &a, Point &b );
-
-//calculate the gradient of the line between 2 points
-double gradient( Point p1, Point p2 );
-//claculate y intercept of line equation
-double yIntercept( double m, Point p );
-//calculate intersection of a line at a given x
-double intersection( double x, Point p1, Point p2 );
-//Check if 3 points make a right turn
-bool rightTurn( Point p1, Point p2, Point p3 );
-
-//Divide and conquer convex hull
-Polygon dcHull( std::vector<Point> sortedPoints );
-//Merge two polygons to create convex hull
-Polygon merge( Polygon leftPolygon, Polygon rightPolygon );
-
-//Convex hull of polygon
-Polygon convexHull( std::vector<Point> sortedPoints );
-//Upper hull of polygon
-std::vector<Point>upperHull( std::vector<Point> points );
-//Lower hull of polygon
-std::vector<Point>lowerHull( std::vector<Point> points );
-//================CONVEX HULL================//
-//===========================================//
+#include <thread>
+#include <climits>
 
 
 //===========================================//
@@ -65,6 +45,26 @@ void pause();
 //=================DEBUGGING=================//
 //===========================================//
 
+
+//===========================================//
+//=================HULL MODES================//
+//Use the column extrema reduction instead of sort + dcHull for on-screen points
+//#define GRIDHULL
+//Print the sharded hull scaling benchmark before opening the window
+//#define SHARDBENCH
+//Run the polygons through the threaded ingest -> sort -> hull -> render pipeline
+//#define PIPELINE
+//Print the rectangle hull query benchmark before opening the window
+//#define RANGEBENCH
+//Print the text against binary hull output benchmark before opening the window
+//#define CODECBENCH
+//Print the 3D hull scaling benchmark before opening the window
+//#define HULL3BENCH
+//Check hullIntersection on touching points and segments before opening the window
+//#define COLLISIONCHECK
+//=================HULL MODES================//
+//===========================================//
+
 bool init()
 {
 	//Initialisation success
@@ -143,8 +143,7 @@ void pause()
 }
 #endif
 
-/*
-bool wayToSort( Point& a, Point& b )
+bool wayToSort( const Point& a, const Point& b )
 {
 	if ( a.getX() != b.getX() )
 	{
@@ -155,11 +154,6 @@ bool wayToSort( Point& a, Point& b )
 		return a.getY() < b.getY();
 	}
 }
-*/
-bool wayToSort( Point& a, Point& b )
-{
-	return a.getX() < b.getX();
-}
 
 double gradient( Point p1, Point p2 )
 {
@@ -497,24 +491,225 @@ Polygon merge( Polygon leftPolygon, Polygon rightPolygon )
 	return mergedPolygon;
 }
 
+//One side of a convex hull read left to right, from its leftmost to its rightmost point.
+//Upper chains are read backwards with y flipped so both bridges can be found as lower bridges
+struct HullChain
+{
+	const Polygon* hull;
+	int start;
+	int length;
+	bool upper;
+
+	HullChain( const Polygon& polygon, bool upperChain )
+	{
+		hull = &polygon;
+		upper = upperChain;
+		start = polygon.getLeftmostIndex();
+
+		int const n = polygon.getSize();
+		int const end = polygon.getRightmostIndex();
+		if ( n == 1 )
+		{
+			length = 1;
+		}
+		else if ( upper )
+		{
+			length = ( start - end + n ) % n + 1;
+		}
+		else
+		{
+			length = ( end - start + n ) % n + 1;
+		}
+	}
+
+	//Index in the polygon of the t-th point along the chain
+	int index( int t )
+	{
+		int const n = hull->getSize();
+		return upper ? ( start - t + n ) % n : ( start + t ) % n;
+	}
+
+	Point at( int t )
+	{
+		const Point& p = hull->getPoint( index( t ) );
+		return upper ? Point( p.getX(), -p.getY() ) : p;
+	}
+};
+
+//Find the lower tangent of two lower chains by binary searching both at once (Overmars - van Leeuwen).
+//Every point of left must have a smaller x than every point of right
+void lowerBridge( HullChain& left, HullChain& right, int& i, int& j )
+{
+	int loL = 0;
+	int hiL = left.length - 1;
+	int loR = 0;
+	int hiR = right.length - 1;
+
+	//Any vertical line strictly between the two chains separates them
+	double const xSplit = left.at( left.length - 1 ).getX() + 0.5;
+
+	while ( true )
+	{
+		i = ( loL + hiL ) / 2;
+		j = ( loR + hiR ) / 2;
+		Point p = left.at( i );
+		Point q = right.at( j );
+
+		//Neighbours of p and q that fall below the line pq
+		bool const leftBelow = i > 0 && turn( p, q, left.at( i - 1 ) ) < 0;
+		bool const leftNextBelow = i < left.length - 1 && turn( p, q, left.at( i + 1 ) ) < 0;
+		bool const rightPrevBelow = j > 0 && turn( p, q, right.at( j - 1 ) ) < 0;
+		bool const rightBelow = j < right.length - 1 && turn( p, q, right.at( j + 1 ) ) < 0;
+
+		if ( !leftBelow && !leftNextBelow && !rightPrevBelow && !rightBelow )
+		{
+			break;
+		}
+
+		//The tangent point on left is before p
+		if ( leftBelow )
+		{
+			hiL = i - 1;
+		}
+		//The tangent point on right is after q
+		if ( rightBelow )
+		{
+			loR = j + 1;
+		}
+		//pq already touches right, so the tangent point on left is after p
+		if ( leftNextBelow && !rightPrevBelow && !rightBelow )
+		{
+			loL = i + 1;
+		}
+		//pq already touches left, so the tangent point on right is before q
+		if ( rightPrevBelow && !leftBelow && !leftNextBelow )
+		{
+			hiR = j - 1;
+		}
+		//Both turn inwards: which side of the split the two edges cross decides which half to drop
+		if ( leftNextBelow && rightPrevBelow )
+		{
+			Point a = p;
+			Point b = left.at( i + 1 );
+			Point c = right.at( j - 1 );
+			Point d = q;
+
+			long long const num = (long long) ( c.getX() - a.getX() ) * ( d.getY() - c.getY() ) - (long long) ( c.getY() - a.getY() ) * ( d.getX() - c.getX() );
+			long long const den = (long long) ( b.getX() - a.getX() ) * ( d.getY() - c.getY() ) - (long long) ( b.getY() - a.getY() ) * ( d.getX() - c.getX() );
+			double const xCross = a.getX() + (double) num / den * ( b.getX() - a.getX() );
+
+			if ( xCross <= xSplit )
+			{
+				loL = i + 1;
+			}
+			else
+			{
+				hiR = j - 1;
+			}
+		}
+	}
+
+	//Skip points lying on the tangent so the merged hull has no collinear points
+	while ( i > 0 && turn( left.at( i ), right.at( j ), left.at( i - 1 ) ) == 0 )
+	{
+		i--;
+	}
+	while ( j < right.length - 1 && turn( left.at( i ), right.at( j ), right.at( j + 1 ) ) == 0 )
+	{
+		j++;
+	}
+}
+
+Polygon bridgeMerge( const Polygon& leftHull, const Polygon& rightHull )
+{
+	HullChain leftLower( leftHull, false );
+	HullChain leftUpper( leftHull, true );
+	HullChain rightLower( rightHull, false );
+	HullChain rightUpper( rightHull, true );
+
+	//Find both tangents in O(log h)
+	int aLower, bLower, aHigher, bHigher;
+	lowerBridge( leftLower, rightLower, aLower, bLower );
+	lowerBridge( leftUpper, rightUpper, aHigher, bHigher );
+
+	//Splice the outside chains together, starting from the leftmost point of the left hull
+	std::vector<Point> mergedPoints;
+	mergedPoints.reserve( aLower + 1 + rightLower.length - bLower + rightUpper.length - bHigher + aHigher );
+
+	appendPoints( mergedPoints, leftHull.getView(), leftLower.index( 0 ), aLower + 1 );
+	appendPoints( mergedPoints, rightHull.getView(), rightLower.index( bLower ), rightLower.length - bLower );
+	//The rightmost point of the right hull ends the lower chain, so start the upper chain after it
+	appendPoints( mergedPoints, rightHull.getView(), rightUpper.index( rightUpper.length - 2 ), rightUpper.length - 1 - bHigher );
+	//The leftmost point of the left hull was the first point added
+	appendPoints( mergedPoints, leftHull.getView(), leftUpper.index( aHigher ), aHigher );
+
+	return Polygon( std::move( mergedPoints ) );
+}
+
+//Append count points of a hull to out, starting at index first and wrapping round the end
+void appendPoints( std::vector<Point>& out, PointView points, int first, int count )
+{
+	if ( count <= 0 )
+	{
+		return;
+	}
+
+	int const firstRun = std::min( count, (int) points.size() - first );
+	out.insert( out.end(), points.begin() + first, points.begin() + first + firstRun );
+	out.insert( out.end(), points.begin(), points.begin() + ( count - firstRun ) );
+}
+
 Polygon dcHull( std::vector<Point> sortedPoints )
+{
+	return dcHull( sortedPoints, 0, sortedPoints.size() );
+}
+
+Polygon dcHull( std::vector<Point>& sortedPoints, size_t begin, size_t end )
 {
 	size_t minSize = 4;
 
-	if ( sortedPoints.size() <= minSize )
+	size_t split = begin;
+	if ( end - begin > minSize )
+	{
+		//Split in the middle, moved so that no x is on both sides
+		split = ( begin + end ) / 2;
+		while ( split < end && sortedPoints.at( split ).getX() == sortedPoints.at( split - 1 ).getX() )
+		{
+			split++;
+		}
+		if ( split == end )
+		{
+			split = ( begin + end ) / 2;
+			while ( split > begin && sortedPoints.at( split ).getX() == sortedPoints.at( split - 1 ).getX() )
+			{
+				split--;
+			}
+		}
+	}
+
+	if ( split == begin )
 	{
 		//no further iteration required
-		return convexHull( sortedPoints );
+		std::vector<Point> points( sortedPoints.begin() + begin, sortedPoints.begin() + end );
+
+		//convexHull needs at least 2 different points
+		if ( points.empty() || points.front() == points.back() )
+		{
+			points.resize( std::min( points.size(), (size_t) 1 ) );
+			return Polygon( points );
+		}
+		return convexHull( points );
 	}
 	else
 	{
-		//split sortedPoints into 2 vectors
-		size_t const nHalf = sortedPoints.size() / 2;
-		std::vector<Point> l1( sortedPoints.begin(), sortedPoints.begin() + nHalf );
-		std::vector<Point> l2( sortedPoints.begin() + nHalf, sortedPoints.end() );
-
 		//next iteration
-		return merge( dcHull( l1 ), dcHull( l2 ) );
+#if defined MERGEDEBUG || defined LINEDEBUG
+		return merge( dcHull( sortedPoints, begin, split ), dcHull( sortedPoints, split, end ) );
+#else
+		Polygon leftHull = dcHull( sortedPoints, begin, split );
+		Polygon rightHull = dcHull( sortedPoints, split, end );
+		return bridgeMerge( leftHull, rightHull );
+#endif
 	}
 }
 
@@ -535,7 +730,7 @@ Polygon convexHull( std::vector<Point> sortedPoints )
 	std::vector<Point> outPolyPoints = lUpper;
 	outPolyPoints.insert( outPolyPoints.end(), lLower.begin(), lLower.end() );
 
-	return Polygon(outPolyPoints);
+	return Polygon( std::move( outPolyPoints ) );
 }
 
 std::vector<Point> upperHull( std::vector<Point> points )
@@ -586,17 +781,223 @@ std::vector<Point> lowerHull( std::vector<Point> points )
 	return lLower;
 }
 
+std::vector<Point> columnExtrema( PointView points, int minX, int width )
+{
+	//No columns, so nothing can be in them
+	if ( width <= 0 )
+	{
+		return std::vector<Point>();
+	}
+
+	//Don't spin up threads for small inputs
+	size_t const minChunk = 1 << 16;
+	size_t nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+	nThreads = std::max( (size_t) 1, std::min( nThreads, points.size() / minChunk ) );
+
+	//Lowest and highest y seen in each column, one set per thread
+	std::vector<std::vector<int>> minY( nThreads, std::vector<int>( width, INT_MAX ) );
+	std::vector<std::vector<int>> maxY( nThreads, std::vector<int>( width, INT_MIN ) );
+
+	//Scan one chunk of the input, skipping stray points outside the grid
+	auto scan = [&]( size_t t )
+	{
+		size_t const begin = points.size() * t / nThreads;
+		size_t const end = points.size() * ( t + 1 ) / nThreads;
+		for ( size_t i = begin; i < end; i++ )
+		{
+			long long const offset = (long long) points[i].getX() - minX;
+			if ( offset < 0 || offset >= width )
+			{
+				continue;
+			}
+			int const column = (int) offset;
+			int const y = points[i].getY();
+			if ( y < minY.at( t ).at( column ) )
+			{
+				minY.at( t ).at( column ) = y;
+			}
+			if ( y > maxY.at( t ).at( column ) )
+			{
+				maxY.at( t ).at( column ) = y;
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for ( size_t t = 1; t < nThreads; t++ )
+	{
+		workers.push_back( std::thread( scan, t ) );
+	}
+	scan( 0 );
+	for ( size_t t = 0; t < workers.size(); t++ )
+	{
+		workers.at( t ).join();
+	}
+
+	//Combine each thread's extremes and emit them column by column (already sorted by x, then y)
+	std::vector<Point> extrema;
+	for ( int column = 0; column < width; column++ )
+	{
+		int lowest = minY.at( 0 ).at( column );
+		int highest = maxY.at( 0 ).at( column );
+		for ( size_t t = 1; t < nThreads; t++ )
+		{
+			lowest = std::min( lowest, minY.at( t ).at( column ) );
+			highest = std::max( highest, maxY.at( t ).at( column ) );
+		}
+
+		//Empty column
+		if ( lowest > highest )
+		{
+			continue;
+		}
+
+		extrema.push_back( Point( minX + column, lowest ) );
+		if ( highest != lowest )
+		{
+			extrema.push_back( Point( minX + column, highest ) );
+		}
+	}
+
+	return extrema;
+}
+
+std::vector<Point> columnExtrema( const std::vector<Point>& points, int minX, int width )
+{
+	return columnExtrema( PointView( points.data(), points.size() ), minX, width );
+}
+
+Polygon gridHull( const std::vector<Point>& points, int minX, int width )
+{
+	return gridHull( PointView( points.data(), points.size() ), minX, width );
+}
+
+Polygon gridHull( PointView points, int minX, int width )
+{
+	std::vector<Point> extrema = columnExtrema( points, minX, width );
+
+	//convexHull needs at least 2 points
+	if ( extrema.size() < 2 )
+	{
+		return Polygon( extrema );
+	}
+
+	return convexHull( extrema );
+}
+
+long long turn( Point p1, Point p2, Point p3 )
+{
+	//Rearranged gradient equation to avoid division by zero (64 bit before subtracting, so the
+	//differences can't overflow even for coordinates at opposite ends of the int range)
+	long long g1 = ( (long long) p2.getY() - p1.getY() ) * ( (long long) p3.getX() - p2.getX() );
+	long long g2 = ( (long long) p3.getY() - p2.getY() ) * ( (long long) p2.getX() - p1.getX() );
+
+	return g2 - g1;
+}
+
 bool rightTurn( Point p1, Point p2, Point p3 )
 {
-	//Rearranged gradient equation to avoid division by zero
-	int g1 = ( p2.getY() - p1.getY() ) * ( p3.getX() - p2.getX() );
-	int g2 = ( p3.getY() - p2.getY() ) * ( p2.getX() - p1.getX() );
+	return turn( p1, p2, p3 ) > 0;
+}
+
+void addProduct( long long a, long long b, unsigned long long& hi, unsigned long long& lo )
+{
+	unsigned long long const ua = a < 0 ? 0ULL - (unsigned long long) a : (unsigned long long) a;
+	unsigned long long const ub = b < 0 ? 0ULL - (unsigned long long) b : (unsigned long long) b;
+	unsigned long long const a0 = ua & 0xFFFFFFFFULL;
+	unsigned long long const a1 = ua >> 32;
+	unsigned long long const b0 = ub & 0xFFFFFFFFULL;
+	unsigned long long const b1 = ub >> 32;
+
+	unsigned long long const p00 = a0 * b0;
+	unsigned long long const p01 = a0 * b1;
+	unsigned long long const p10 = a1 * b0;
+	unsigned long long const mid = ( p00 >> 32 ) + ( p01 & 0xFFFFFFFFULL ) + ( p10 & 0xFFFFFFFFULL );
+	unsigned long long productLo = ( p00 & 0xFFFFFFFFULL ) | ( mid << 32 );
+	unsigned long long productHi = a1 * b1 + ( p01 >> 32 ) + ( p10 >> 32 ) + ( mid >> 32 );
+	if ( ( a < 0 ) != ( b < 0 ) )
+	{
+		productLo = ~productLo + 1;
+		productHi = ~productHi + ( productLo == 0 ? 1 : 0 );
+	}
+
+	lo += productLo;
+	hi += productHi + ( lo < productLo ? 1 : 0 );
+}
+
+int sign128( unsigned long long hi, unsigned long long lo )
+{
+	if ( (long long) hi < 0 )
+	{
+		return -1;
+	}
+	return ( hi == 0 && lo == 0 ) ? 0 : 1;
+}
+
+bool insideHull( PointView hull, Point p )
+{
+	int const n = hull.size();
+	if ( n == 0 )
+	{
+		return false;
+	}
+	if ( n == 1 )
+	{
+		return hull[0] == p;
+	}
+	if ( n == 2 )
+	{
+		//On the segment: in line with it and not beyond either end
+		long long const along = ( (long long) p.getX() - hull[0].getX() ) * ( (long long) p.getX() - hull[1].getX() ) + ( (long long) p.getY() - hull[0].getY() ) * ( (long long) p.getY() - hull[1].getY() );
+		return turn( hull[0], hull[1], p ) == 0 && along <= 0;
+	}
+	if ( turn( hull[0], hull[1], p ) < 0 || turn( hull[0], hull[n - 1], p ) > 0 )
+	{
+		return false;
+	}
 
-	return g1 < g2;
+	//Binary search over the fan of triangles from the first point
+	int lo = 1;
+	int hi = n - 1;
+	while ( hi - lo > 1 )
+	{
+		int const mid = ( lo + hi ) / 2;
+		if ( turn( hull[0], hull[mid], p ) >= 0 )
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return turn( hull[lo], hull[hi], p ) >= 0;
 }
 
 int main( int argc, char* args[] )
 {
+	//Started by processShardedHull to hull one shard
+	if ( isShardWorker( argc, args ) )
+	{
+		return runShardWorker( argc, args );
+	}
+
+#ifdef SHARDBENCH
+	benchmarkShardedHull( 4000000, std::max( 1u, std::thread::hardware_concurrency() ) );
+#endif
+#ifdef RANGEBENCH
+	benchmarkHullIndex( 10000000, 1000 );
+#endif
+#ifdef CODECBENCH
+	benchmarkHullCodec( 100000 );
+#endif
+#ifdef HULL3BENCH
+	benchmarkHull3( 10000000, std::max( 1u, std::thread::hardware_concurrency() ) );
+#endif
+#ifdef COLLISIONCHECK
+	checkHullIntersection();
+#endif
+
 	if( !init() )
 	{
 		std::cout << "Failed to initialise." << std::endl;
@@ -641,24 +1042,65 @@ int main( int argc, char* args[] )
 		polygons.at( 2 ).addPoint( b );
 		polygons.at( 2 ).addPoint( c );
 
+#ifdef PIPELINE
+		//Feed the polygons in from another thread while this one renders the hulls coming out.
+		//The polygons aren't needed after this, so their points are moved into the batches
+		Pipeline pipeline( 2 );
+		std::thread feeder( [&]
+		{
+			for( size_t i = 0; i < polygons.size(); i++ )
+			{
+				pipeline.ingest( polygons.at(i).takePoints() );
+			}
+			pipeline.finish();
+		} );
+
+		HullBatch batch;
+		for( int i = 0; pipeline.nextHull( batch ); i++ )
+		{
+			//set draw colour to make different paths clear
+			if( i == 0 ) SDL_SetRenderDrawColor( gRenderer, 0x00, 0xFF, 0xFF, SDL_ALPHA_OPAQUE );
+			if( i == 1 ) SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0x00, SDL_ALPHA_OPAQUE );
+			if( i == 2 ) SDL_SetRenderDrawColor( gRenderer, 0xFF, 0x00, 0xFF, SDL_ALPHA_OPAQUE );
+			batch.hull.drawPolygon( gRenderer );
+
+			for( size_t j = 0; j < batch.points.size(); j++ )
+			{
+				batch.points.at( j ).drawPoint( gRenderer, 0xFF, 0x00, 0x00, SDL_ALPHA_OPAQUE );
+			}
+		}
+		feeder.join();
+
+		const char* stageNames[STAGE_COUNT] = { "ingest", "sort", "hull", "render" };
+		for( int stage = 0; stage < STAGE_COUNT; stage++ )
+		{
+			StageStats stats = pipeline.getStats( (PipelineStage) stage );
+			std::cout << stageNames[stage] << ": " << stats.batches << " batches, " << stats.averageMs << " ms average, " << stats.maxMs << " ms max, " << stats.queueDepth << " queued" << std::endl;
+		}
+		std::cout << "end to end: " << pipeline.getAverageLatency() << " ms average" << std::endl;
+#else
 		//Calculate convex hull for each polygon
 		for( int i = 0; i < polygons.size(); i++ )
 		{
-			std::vector<Point> sortedPoints = polygons.at(i).getPoints();
-			std::sort( sortedPoints.begin(), sortedPoints.end(), wayToSort );
-
 			//set draw colour to make different paths clear
 			if( i == 0 ) SDL_SetRenderDrawColor( gRenderer, 0x00, 0xFF, 0xFF, SDL_ALPHA_OPAQUE );
 			if( i == 1 ) SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0x00, SDL_ALPHA_OPAQUE );
 			if( i == 2 ) SDL_SetRenderDrawColor( gRenderer, 0xFF, 0x00, 0xFF, SDL_ALPHA_OPAQUE );
-			dcHull( sortedPoints ).drawPolygon( gRenderer );
 
-			for( size_t j = 0; j < polygons.at(i).getPoints().size(); j++ )
+#ifdef GRIDHULL
+			gridHull( polygons.at(i).getView(), 0, SCREEN_WIDTH ).drawPolygon( gRenderer );
+#else
+			polygons.at(i).hull().drawPolygon( gRenderer );
+#endif
+
+			PointView points = polygons.at(i).getView();
+			for( size_t j = 0; j < points.size(); j++ )
 			{
-				polygons.at(i).getPoints().at( j ).drawPoint( gRenderer, 0xFF, 0x00, 0x00, SDL_ALPHA_OPAQUE );
+				points[j].drawPoint( gRenderer, 0xFF, 0x00, 0x00, SDL_ALPHA_OPAQUE );
 			}
 
 		}
+#endif
 
 		//Draw points
 		a.drawPoint( gRenderer, 0x00, 0x00, 0xFF, SDL_ALPHA_OPAQUE );